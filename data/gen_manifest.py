@@ -1,11 +1,29 @@
-import json, os, os.path, dataclasses
+import json, os, os.path, dataclasses, subprocess, sys
 
 THIS_DIR = os.path.dirname(os.path.realpath(__file__))
 PROJECT_DIR = os.path.dirname(THIS_DIR)
 
 ASSET_TEXTURE = 0
 TEXTURE_EXTS = ['png', 'jpg', 'jpeg', 'gif']
-IGNORE_EXTS = ['json', 'ini', 'py'] # TODO
+# `--qoi` converts these with qoitool (`ninja qoitool`), QOI decodes several times faster.
+QOI_EXTS = ['png']
+QOITOOL = os.path.join(PROJECT_DIR, 'qoitool')
+
+# enum rain_texture_format
+TEXTURE_FORMAT_GREY = 1
+TEXTURE_FORMAT_GREY_ALPHA = 2
+TEXTURE_FORMAT_RGB = 3
+TEXTURE_FORMAT_RGB_ALPHA = 4
+
+# png color type -> format, palettes may have alpha.
+PNG_FORMATS = {
+	0: TEXTURE_FORMAT_GREY,
+	2: TEXTURE_FORMAT_RGB,
+	3: TEXTURE_FORMAT_RGB_ALPHA,
+	4: TEXTURE_FORMAT_GREY_ALPHA,
+	6: TEXTURE_FORMAT_RGB_ALPHA,
+}
+IGNORE_EXTS = ['json', 'ini', 'py', 'qoi'] # TODO
 
 @dataclasses.dataclass
 class Asset:
@@ -20,8 +38,41 @@ class TextureAsset(Asset):
 
 # TODO: Take into account old IDs!
 
-def gen_manifest(path: str, idbase: int) -> list[Asset]:
+def texture_format(filepath: str, ext: str) -> int:
+	"""the channels the file has, so masks and opaque images load compact."""
+	if ext in ['jpg', 'jpeg']: return TEXTURE_FORMAT_RGB
+	if ext == 'png':
+		with open(os.path.join(PROJECT_DIR, filepath), 'rb') as f:
+			header = f.read(26)
+		# signature (8), IHDR length and type (8), width, height, depth, color type.
+		if len(header) == 26 and header[12:16] == b'IHDR':
+			return PNG_FORMATS.get(header[25], TEXTURE_FORMAT_RGB_ALPHA)
+	return TEXTURE_FORMAT_RGB_ALPHA
+
+def convert_qoi(filepath: str) -> str:
+	"""the path of an up to date QOI copy of the file."""
+	qoipath = filepath[:filepath.rfind(os.path.extsep)] + '.qoi'
+	src, dst = os.path.join(PROJECT_DIR, filepath), os.path.join(PROJECT_DIR, qoipath)
+	if not os.path.exists(dst) or os.path.getmtime(dst) < os.path.getmtime(src):
+		subprocess.run([QOITOOL, 'convert', src, dst], check = True)
+	return qoipath
+
+# formats picked by hand, by source path, e.g. `{ "data/mask.png": 4 }`.
+# the source path stays the key with `--qoi`, not the converted one.
+FORMAT_OVERRIDES = os.path.join(THIS_DIR, 'formats.json')
+
+def format_overrides() -> dict[str, int]:
+	"""formats picked by hand win over the detected ones."""
+	try:
+		with open(FORMAT_OVERRIDES) as fin:
+			return json.load(fin)
+	except OSError:
+		return {}
+
+def gen_manifest(path: str, idbase: int, qoi: bool) -> list[Asset]:
 	items: list[Asset] = []
+	formats = format_overrides()
+	unused = set(formats)
 	for (dirpath, _, filenames) in os.walk(path):
 		for filename in filenames:
 			filepath = os.path.relpath(
@@ -33,19 +84,25 @@ def gen_manifest(path: str, idbase: int) -> list[Asset]:
 			ext = filename[filename.rfind(os.path.extsep)+1:].lower()
 
 			if ext in TEXTURE_EXTS:
+				# looked up before `filepath` may be replaced by the QOI copy.
+				fmt = formats.get(filepath, texture_format(filepath, ext))
+				unused.discard(filepath)
 				items.append(TextureAsset(
 					idbase + len(items), ASSET_TEXTURE,
 					os.path.relpath(filepath, THIS_DIR),
-					format=4, path=filepath
+					format=fmt,
+					path=convert_qoi(filepath) if qoi and ext in QOI_EXTS else filepath
 				))
 			elif ext not in IGNORE_EXTS:
 				print(f"unknown file extension: '{ext}'. file: {filepath}")
 
+	for filepath in sorted(unused):
+		print(f"format override for a texture that doesn't exist: {filepath}")
 	return items
 
 items = list(map(
 	dataclasses.asdict,
-	gen_manifest(os.path.dirname(os.path.realpath(__file__)), 1)
+	gen_manifest(os.path.dirname(os.path.realpath(__file__)), 1, '--qoi' in sys.argv)
 ))
 
 with open(os.path.join(THIS_DIR, 'manifest.json'), 'w') as fout:
@@ -97,6 +97,8 @@
 // Your renderer backend will need to support it (most example renderer backends support both 16/32-bit indices).
 // Another way to allow large meshes while keeping 16-bit indices is to handle ImDrawCmd::VtxOffset in your renderer.
 // Read about ImGuiBackendFlags_RendererHasVtxOffset for details.
+// rain: imgui_binds.cpp handles both, but the cimgui bundled with ImGui.NET
+// writes into the same draw lists with 16-bit indices, so keep them in sync.
 //#define ImDrawIdx unsigned int
 
 //---- Override ImDrawCallback signature (will need to modify renderer backends accordingly)
@@ -0,0 +1,64 @@
+#ifndef RAIN__ASSETS_H_
+#define RAIN__ASSETS_H_
+#include <stdint.h>
+#include <stdbool.h>
+#include <rain/compat.h>
+
+/** maximum number of live assets. the slot arrays never move,
+    so managed code can keep pointers into them. */
+#define RAIN_ASSETS_MAX 65536
+
+/** index + generation. a zeroed handle is always invalid. */
+struct rain_asset_handle {
+	uint32_t index;
+	uint32_t generation;
+};
+
+/** slot map of loaded assets, shared with `RainEngine.AssetManager`.
+    removing or replacing an asset bumps the slot generation,
+    which invalidates all old handles to it. */
+struct rain_assets {
+	/** generation per slot, 0 is never a valid generation. */
+	uint32_t *generations;
+	/** native data per slot (e.g. `struct rain_texture *`), may be null. */
+	void **data;
+	uint32_t *free_slots;
+	uint32_t free_count;
+	/** slots [1, used) have been handed out at least once. slot 0 is reserved. */
+	uint32_t used;
+};
+
+void rain_assets_init(struct rain_assets *this_);
+void rain_assets_deinit(struct rain_assets *this_);
+
+/** returns a zeroed handle if full. */
+struct rain_asset_handle rain_assets_insert(struct rain_assets *this_, void *data);
+
+/** does nothing if the handle is stale. */
+void rain_assets_remove(struct rain_assets *this_, struct rain_asset_handle handle);
+
+/** swap the data of a live asset (after a reload), invalidating old handles.
+    returns false and leaves `handle` untouched if it was stale. */
+bool rain_assets_replace(
+	struct rain_assets *RAIN_RESTRICT this_,
+	struct rain_asset_handle *RAIN_RESTRICT handle,
+	void *data
+);
+
+static inline bool rain_assets_is_valid(
+	const struct rain_assets *this_,
+	struct rain_asset_handle handle
+) {
+	return handle.generation != 0 && handle.index < RAIN_ASSETS_MAX
+		&& this_->generations[handle.index] == handle.generation;
+}
+
+/** null if the handle is stale. */
+static inline void *rain_assets_get(
+	const struct rain_assets *this_,
+	struct rain_asset_handle handle
+) {
+	return rain_assets_is_valid(this_, handle) ? this_->data[handle.index] : nullptr;
+}
+
+#endif // RAIN__ASSETS_H_
@@ -0,0 +1,54 @@
+#ifndef RAIN__JOBS_H_
+#define RAIN__JOBS_H_
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+/** worker threads at most, the main thread comes on top. */
+#define RAIN_JOBS_MAX_WORKERS 63
+/** jobs per thread deque, a power of two. scheduling onto a
+    full deque runs the job right away instead. */
+#define RAIN_JOBS_DEQUE_SIZE 4096
+
+/** every job works on the items [begin, end) of a range. */
+typedef void (*rain_job_fn)(void *data, size_t begin, size_t end);
+
+/** number of unfinished jobs scheduled with it. zero-initialize it
+    and keep it alive until `rain_jobs_wait` returns. */
+struct rain_jobs_counter {
+	atomic_size_t pending;
+};
+
+/** start the workers. `worker_count` 0 uses one per core but the main
+    thread's, `RAIN_JOBS_WORKERS` overrides both.
+    must be called from the main thread. */
+void rain_jobs_init(int worker_count);
+
+/** finish queued jobs and join the workers. */
+void rain_jobs_deinit();
+
+/** worker threads, not counting the main thread. */
+int rain_jobs_worker_count();
+
+/** split [0, count) into jobs of `batch` items (0 picks a size) and
+    queue them on the calling thread. each job increments `counter`
+    (if given) and decrements it when done. no job starts before `after`
+    (if given) reaches zero, which is how dependencies are expressed.
+    only the main thread and jobs may schedule. */
+void rain_jobs_parallel_for(
+	rain_job_fn fn,
+	void *data,
+	size_t count,
+	size_t batch,
+	struct rain_jobs_counter *counter,
+	struct rain_jobs_counter *after
+);
+
+/** run queued jobs on the calling thread until `counter` reaches zero. */
+void rain_jobs_wait(struct rain_jobs_counter *counter);
+
+static inline bool rain_jobs_done(struct rain_jobs_counter *counter) {
+	return atomic_load_explicit(&counter->pending, memory_order_acquire) == 0;
+}
+
+#endif // RAIN__JOBS_H_
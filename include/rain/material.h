@@ -0,0 +1,87 @@
+#ifndef RAIN__MATERIAL_H_
+#define RAIN__MATERIAL_H_
+
+#include <rain/compat.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <sokol_gfx.h>
+#include <rain/math.h>
+
+/** vec4 parameters a material can have. */
+#define RAIN_MATERIAL_MAX_PARAMS 16
+
+enum rain_blend_mode {
+	RAIN_BLEND_OPAQUE = 0,
+	RAIN_BLEND_ALPHA = 1,
+	RAIN_BLEND_ADDITIVE = 2,
+	RAIN_BLEND_PREMULTIPLIED = 3,
+};
+
+/** fixed function state, picks the pipeline together with the shader. */
+struct rain_material_state {
+	/** enum rain_blend_mode */
+	uint32_t blend;
+	bool depth_test;
+	bool depth_write;
+};
+
+/** fragment stage for quads, the vertex stage is the same for all. */
+struct rain_shader {
+	sg_shader shader;
+	uint32_t param_count;
+	bool textured;
+};
+
+struct rain_material {
+	const struct rain_shader *shader;
+	struct rain_material_state state;
+	/** shared with every material of the same shader and state. */
+	sg_pipeline pipeline;
+	/** unique, for sorting draws by material. */
+	uint32_t id;
+
+	/** written on the main thread. */
+	rain_float4 params[RAIN_MATERIAL_MAX_PARAMS];
+	/** copy the render thread draws with, updated in order with the draws. */
+	rain_float4 render_params_[RAIN_MATERIAL_MAX_PARAMS];
+	/** bumped with `render_params_`, tells the renderer to upload them again. */
+	uint32_t render_version_;
+};
+
+/** compile a quad fragment shader. `fs_body` is GLSL 330 without the
+    version line, these are declared in front of it:
+      in vec2 s_uv; out vec4 o_color; uniform vec4 u_tint;
+      uniform vec4 u_params[param_count]; (if param_count > 0)
+      uniform sampler2D u_texture; (if textured)
+    shaders live until `rain_materials_deinit`. */
+void rain_shader_init(
+	struct rain_shader *RAIN_RESTRICT this_,
+	const char *label,
+	const char *fs_body,
+	uint32_t param_count,
+	bool textured
+);
+
+/** params start zeroed. `shader` must outlive the material. */
+void rain_material_init(
+	struct rain_material *RAIN_RESTRICT this_,
+	const struct rain_shader *RAIN_RESTRICT shader,
+	struct rain_material_state state
+);
+
+/** set `count` params starting at `first`. draws recorded before this
+    keep the old values, the new ones are uploaded once on the next draw. */
+void rain_material_set_params(
+	struct rain_material *RAIN_RESTRICT this_,
+	uint32_t first,
+	uint32_t count,
+	const rain_float4 *RAIN_RESTRICT values
+);
+
+/** free a heap allocated material once the frames using it are done. */
+void rain_material_destroy_and_free(struct rain_material *this_);
+
+/** destroys every shader and cached pipeline. */
+void rain_materials_deinit();
+
+#endif // RAIN__MATERIAL_H_
@@ -0,0 +1,49 @@
+#ifndef RAIN__QOI_H_
+#define RAIN__QOI_H_
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <rain/compat.h>
+
+/** "Quite OK Image" files, lossless and a lot faster to decode than PNG.
+    @see https://qoiformat.org/qoi-specification.pdf */
+
+#define RAIN_QOI_HEADER_SIZE 14
+/** what the reference implementation refuses to go over. */
+#define RAIN_QOI_PIXELS_MAX 400000000u
+
+struct rain_qoi_desc {
+	uint32_t width, height;
+	/** 3 or 4. */
+	uint8_t channels;
+	/** 0 sRGB with linear alpha, 1 all linear. */
+	uint8_t colorspace;
+};
+
+/** false if `data` doesn't start with a valid QOI header. */
+bool rain_qoi_read_header(
+	const uint8_t *RAIN_RESTRICT data,
+	size_t size,
+	struct rain_qoi_desc *RAIN_RESTRICT out_desc
+);
+
+/** decode into `channels` (3 or 4, 0 for the file's) bytes per pixel,
+    bottom row first if `flip_vertically`. the result is malloc'd,
+    null if the file is invalid. */
+uint8_t *rain_qoi_decode(
+	const uint8_t *RAIN_RESTRICT data,
+	size_t size,
+	int channels,
+	bool flip_vertically,
+	struct rain_qoi_desc *RAIN_RESTRICT out_desc
+);
+
+/** `pixels` are tightly packed rows of `desc->channels`. the result is
+    malloc'd, null if `desc` is invalid. */
+uint8_t *rain_qoi_encode(
+	const uint8_t *RAIN_RESTRICT pixels,
+	const struct rain_qoi_desc *RAIN_RESTRICT desc,
+	size_t *RAIN_RESTRICT out_size
+);
+
+#endif // RAIN__QOI_H_
@@ -9,18 +9,70 @@
 #include <rain/transform.h>
 #include <rain/camera.h>
 #include <rain/math.h>
+#include <rain/material.h>
+
+/** replaces how quads are shaded, to see where the GPU time goes. */
+enum rain_renderer_debug_view {
+	RAIN_RENDERER_DEBUG_VIEW_NONE = 0,
+	/** every quad adds a bit of heat, bright means drawn over many times. */
+	RAIN_RENDERER_DEBUG_VIEW_OVERDRAW = 1,
+	/** quads tinted by batch, a new color starts where state changed. */
+	RAIN_RENDERER_DEBUG_VIEW_BATCHES = 2,
+	/** red for quads switching pipeline, yellow for texture, grey for none. */
+	RAIN_RENDERER_DEBUG_VIEW_STATE_CHANGES = 3,
+};
+
+/** what the render thread did with sokol for one frame, ImGui and
+    thumbnails included. NB: mirrored by Renderer.FrameStats in C#. */
+struct rain_renderer_stats {
+	/** sg_draw calls. */
+	uint32_t draws;
+	uint32_t instances;
+	/** sg_apply_pipeline calls. */
+	uint32_t pipeline_changes;
+	/** sg_apply_bindings calls, for a new pipeline or texture. */
+	uint32_t binding_changes;
+	/** sg_apply_uniforms calls. */
+	uint32_t uniform_applies;
+	/** material params uploaded, part of `uniform_applies`. */
+	uint32_t material_uploads;
+	uint64_t uniform_bytes;
+	/** uploaded to buffers, on creation or update. */
+	uint64_t buffer_bytes;
+	/** uploaded to images, on creation or update. */
+	uint64_t image_bytes;
+	/** held by all images at the end of the frame, not reset per frame. */
+	uint64_t texture_memory;
+	/** `rain_texture_update` rects copied to their textures. */
+	uint32_t texture_updates;
+	/** still queued after this frame's, over the upload budget. */
+	uint32_t texture_updates_deferred;
+	/** frames the upload ring had to wait for the GPU to finish reading. */
+	uint32_t upload_ring_waits;
+	uint64_t texture_update_bytes;
+	/** vertices, indices and pixels written to the upload ring. */
+	uint64_t upload_ring_bytes;
+};
 
 struct rain_renderer {
 	struct rain_window *window;
 	struct rain__renderer_current_ {
 		sg_pipeline pipeline;
 		sg_bindings bind;
+		/** whose params were uploaded last, and which version of them. */
+		const struct rain_material *material;
+		uint32_t material_version;
+		/** `bind` changed since it was last applied. */
+		bool bind_dirty;
+		struct rain_renderer_stats stats;
+		enum rain_renderer_debug_view debug_view;
 	} current_;
 	struct rain__renderer_builtin_ {
-		sg_pipeline textured_quad_pipeline;
-		sg_pipeline colored_quad_pipeline;
-		sg_shader textured_quad_shader;
-		sg_shader colored_quad_shader;
+		struct rain_shader textured_quad_shader;
+		struct rain_shader colored_quad_shader;
+		struct rain_material textured_quad_material;
+		struct rain_material colored_quad_material;
+		struct rain_material overdraw_material;
 		sg_buffer quad_vertex_buffer;
 		sg_sampler nearest_sampler;
 	} builtin_;
@@ -41,6 +93,22 @@ void rain_renderer_begin_render(struct rain_renderer *this_);
 /** end rendering a frame. */
 void rain_renderer_end_render(struct rain_renderer *this_);
 
+/** render thread only. forget the applied pipeline and bindings,
+    e.g. after a new pass or someone else applying their own. */
+void rain_renderer_reset_state(struct rain_renderer *this_);
+
+/** takes effect from the next recorded quad on. */
+void rain_renderer_set_debug_view(
+	struct rain_renderer *this_,
+	enum rain_renderer_debug_view view
+);
+
+/** stats of the last frame the render thread finished. */
+void rain_renderer_get_stats(
+	struct rain_renderer *RAIN_RESTRICT this_,
+	struct rain_renderer_stats *RAIN_RESTRICT out_stats
+);
+
 struct rain_renderer_rect {
 	size_t offset_x;
 	size_t offset_y;
@@ -57,6 +125,18 @@ void rain_renderer_render_textured_quad(
 	const rain_float4x4 *RAIN_RESTRICT transform
 );
 
+/** draw a quad with `material`. `texture` is only used (and required)
+    if the material's shader is textured. */
+void rain_renderer_render_quad(
+	struct rain_renderer *RAIN_RESTRICT this_,
+	const struct rain_material *RAIN_RESTRICT material,
+	const struct rain_texture *RAIN_RESTRICT texture,
+	const struct sg_sampler sampler,
+	const struct rain_renderer_rect *rect,
+	const rain_float4 *RAIN_RESTRICT tint,
+	const rain_float4x4 *RAIN_RESTRICT transform
+);
+
 void rain_renderer_render_colored_quad(
 	struct rain_renderer *RAIN_RESTRICT this_,
 	rain_float4 color,
@@ -1,10 +1,15 @@
 #ifndef RAIN__TEXTURE_H_
 #define RAIN__TEXTURE_H_
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
 #include <sokol_gfx.h>
 #include <rain/compat.h>
 #include <rain/math.h>
 
-/** @see stb_image */
+/** channels of the pixels, @see stb_image. GREY and GREY_ALPHA are
+    uploaded as R8 and RG8 and swizzled so they sample as grey RGBA,
+    RGB is padded to RGBA8. */
 enum rain_texture_format {
 	RAIN_TEXTURE_FORMAT_UNKNOWN = 0,
 	RAIN_TEXTURE_FORMAT_GREY = 1,
@@ -13,14 +18,43 @@ enum rain_texture_format {
 	RAIN_TEXTURE_FORMAT_RGB_ALPHA = 4,
 };
 
+struct rain_texture_stream;
+
 struct rain_texture {
 	bool exists;
+	/** swapped for another when a streamed texture changes mips. */
 	sg_image image;
+	/** of mip 0, even when it isn't resident. */
 	int width, height;
 	sg_pixel_format format;
+	/** what was loaded into it, unknown for render targets. */
+	enum rain_texture_format channels;
+	/** SG_USAGE_DYNAMIC ones can be changed with `rain_texture_update`. */
 	sg_usage usage;
+	/** null unless loaded by `rain_texture_streaming_load`. */
+	struct rain_texture_stream *stream;
 };
 
+/** decode a QOI file or anything stb_image reads, bottom row first.
+    `channels` 0 keeps the file's. the result is malloc'd, null (after
+    logging why) on failure. safe to call from any thread. */
+uint8_t *rain_texture_load_pixels(
+	const char *RAIN_RESTRICT path,
+	int *RAIN_RESTRICT out_width,
+	int *RAIN_RESTRICT out_height,
+	int *RAIN_RESTRICT out_file_channels,
+	int channels
+);
+
+/** size and channels from the file's header. */
+bool rain_texture_file_info(
+	const char *RAIN_RESTRICT path,
+	int *RAIN_RESTRICT out_width,
+	int *RAIN_RESTRICT out_height,
+	int *RAIN_RESTRICT out_channels
+);
+
+/** `format` unknown keeps the channels the file has. */
 void rain_texture_from_file(
 	struct rain_texture *RAIN_RESTRICT this_,
 	const char *RAIN_RESTRICT path,
@@ -28,6 +62,22 @@ void rain_texture_from_file(
 	sg_usage usage
 );
 
+/** `pixels` are tightly packed rows of `format`, which must be known. */
+void rain_texture_from_pixels(
+	struct rain_texture *RAIN_RESTRICT this_,
+	const uint8_t *RAIN_RESTRICT pixels,
+	int width, int height,
+	enum rain_texture_format format,
+	sg_usage usage
+);
+
+/** pad RGB8 pixels to RGBA8 with opaque alpha. */
+void rain_texture_rgb_to_rgba(
+	uint8_t *RAIN_RESTRICT dst,
+	const uint8_t *RAIN_RESTRICT src,
+	size_t pixels
+);
+
 void rain_texture_destroy(struct rain_texture *this_);
 
 #endif // RAIN__TEXTURE_H_
@@ -0,0 +1,101 @@
+#ifndef RAIN__TEXTURE_STREAMING_H_
+#define RAIN__TEXTURE_STREAMING_H_
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <threads.h>
+#include <rain/texture.h>
+
+/** streamed textures start with the mips no larger than this. */
+#define RAIN_TEXTURE_STREAMING_MIN_SIZE 64
+/** enough for 32k textures. */
+#define RAIN_TEXTURE_STREAMING_MAX_MIPS 16
+/** for all streamed textures, `RAIN_TEXTURE_BUDGET_MB` overrides it. */
+#define RAIN_TEXTURE_STREAMING_BUDGET (256ull << 20)
+/** a mip unused for this many frames may be dropped when over budget. */
+#define RAIN_TEXTURE_STREAMING_IDLE_FRAMES 300
+
+/** a texture whose image holds the chain from `resident_mip` on,
+    loaded from `path` again when a finer mip is drawn. */
+struct rain_texture_stream {
+	struct rain_texture_streaming *streaming;
+	/** null once the texture is destroyed. */
+	struct rain_texture *texture;
+	char *path;
+	/** of mip 0, same as the texture's. */
+	int width, height;
+	int mip_count;
+	/** what the texture started with, never dropped. */
+	int base_mip;
+	int resident_mip;
+	/** finest mip asked for since the last update, `mip_count` if none. */
+	int wanted_mip;
+	/** being loaded, -1 if none. */
+	int loading_mip;
+	/** frame each mip was last asked for. */
+	uint64_t last_wanted[RAIN_TEXTURE_STREAMING_MAX_MIPS];
+	uint64_t resident_bytes;
+	/** RGBA8 chain from `lower_mip` on, the mips below the finest one
+	    loaded. kept so dropping mips needs no decode, null at `base_mip`. */
+	uint8_t *lower;
+	int lower_mip;
+};
+
+struct rain__texture_stream_job_ {
+	struct rain_texture_stream *stream;
+	int mip;
+	/** higher is loaded first. */
+	uint32_t priority;
+	/** when done: the chain from `mip` on, RGBA8 and tightly packed.
+	    null if loading failed. */
+	uint8_t *pixels;
+};
+
+/** loads the finer mips of textures on a worker thread when something
+    draws them large enough, and drops them again when over budget. */
+struct rain_texture_streaming {
+	bool enabled, started;
+	uint64_t frame;
+	uint64_t budget, resident_bytes;
+	/** main thread. */
+	struct rain_texture_stream **streams;
+	size_t stream_count, stream_capacity;
+
+	thrd_t worker;
+	mtx_t lock;
+	cnd_t wake;
+	bool quit;
+	/** a binary heap by priority. */
+	struct rain__texture_stream_job_ *pending;
+	size_t pending_count, pending_capacity;
+	struct rain__texture_stream_job_ *done;
+	size_t done_count, done_capacity;
+};
+
+/** `RAIN_TEXTURE_STREAMING=off` loads every texture whole instead. */
+void rain_texture_streaming_init(struct rain_texture_streaming *this_);
+void rain_texture_streaming_deinit(struct rain_texture_streaming *this_);
+
+/** like `rain_texture_from_file` with an immutable image, but only the
+    low mips are uploaded. streamed textures are RGBA8, GREY and
+    GREY_ALPHA ones (and all of them when streaming is off) load whole. */
+void rain_texture_streaming_load(
+	struct rain_texture_streaming *RAIN_RESTRICT this_,
+	struct rain_texture *RAIN_RESTRICT texture,
+	const char *RAIN_RESTRICT path,
+	enum rain_texture_format format
+);
+
+/** main thread. `mip` of the full chain is drawn this frame. */
+static inline void rain_texture_stream_request(struct rain_texture_stream *this_, int mip) {
+	if (mip < this_->wanted_mip) this_->wanted_mip = mip < 0 ? 0 : mip;
+}
+
+/** called by `rain_texture_destroy`. */
+void rain_texture_stream_release(struct rain_texture_stream *this_);
+
+/** swap in finished mips and queue what was asked for since the last call.
+    call once per frame from the main thread. */
+void rain_texture_streaming_update(struct rain_texture_streaming *this_);
+
+#endif // RAIN__TEXTURE_STREAMING_H_
@@ -0,0 +1,64 @@
+#ifndef RAIN__TEXTURE_UPLOAD_H_
+#define RAIN__TEXTURE_UPLOAD_H_
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <rain/texture.h>
+
+struct rain_renderer;
+
+/** bytes per frame, `RAIN_TEXTURE_UPLOAD_BUDGET_KB` overrides it. */
+#define RAIN_TEXTURE_UPLOAD_BUDGET (4u << 20)
+
+struct rain__texture_update_ {
+	sg_image image;
+	sg_pixel_format format;
+	int x, y, width, height;
+	/** of the pixels, in `bytes` while queued and among the frame's after. */
+	size_t offset, size;
+};
+
+/** updates of dynamic textures. queued on the main thread and copied to
+    the GPU on the render thread, through the upload ring so neither of
+    them waits for the GPU to finish reading. */
+struct rain_texture_uploads {
+	struct rain_renderer *renderer;
+	size_t budget;
+	/** main thread, in the order they were made. */
+	struct rain__texture_update_ *queued;
+	size_t queued_count, queued_capacity;
+	uint8_t *bytes;
+	size_t bytes_size, bytes_capacity;
+	/** updates ever queued and ever recorded, an update numbered n by
+	    `rain_texture_update` is recorded once `recorded` reaches n. */
+	uint64_t queued_serial, recorded_serial;
+};
+
+void rain_texture_uploads_init(
+	struct rain_texture_uploads *RAIN_RESTRICT this_,
+	struct rain_renderer *RAIN_RESTRICT renderer
+);
+
+/** drops whatever is still queued. */
+void rain_texture_uploads_deinit(struct rain_texture_uploads *this_);
+
+/** replace `width` x `height` texels at `x`, `y` of a texture created with
+    SG_USAGE_DYNAMIC. `pixels` are tightly packed rows of the texture's
+    channels, in the order it was loaded in (bottom row first). they are
+    copied, the texture changes before the next frame that flushes it
+    draws. false (after logging why) if the rect or size don't fit,
+    otherwise `queued_serial` is its number. */
+bool rain_texture_update(
+	struct rain_texture_uploads *RAIN_RESTRICT this_,
+	const struct rain_texture *RAIN_RESTRICT texture,
+	int x, int y, int width, int height,
+	const uint8_t *RAIN_RESTRICT pixels,
+	size_t size
+);
+
+/** record the queued updates up to the budget, in order, the rest wait
+    for the next frames. one larger than the budget goes alone. call once
+    per frame after `rain_renderer_begin_render`, before anything draws. */
+void rain_texture_uploads_flush(struct rain_texture_uploads *this_);
+
+#endif // RAIN__TEXTURE_UPLOAD_H_
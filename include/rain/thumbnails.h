@@ -0,0 +1,66 @@
+#ifndef RAIN__THUMBNAILS_H_
+#define RAIN__THUMBNAILS_H_
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <threads.h>
+#include <rain/texture.h>
+
+/** thumbnails are letterboxed into squares of this size. */
+#define RAIN_THUMBNAIL_SIZE 64
+#define RAIN_THUMBNAIL_ATLAS_SIZE 1024
+#define RAIN_THUMBNAIL_ATLAS_COLUMNS (RAIN_THUMBNAIL_ATLAS_SIZE / RAIN_THUMBNAIL_SIZE)
+#define RAIN_THUMBNAIL_SLOTS (RAIN_THUMBNAIL_ATLAS_COLUMNS * RAIN_THUMBNAIL_ATLAS_COLUMNS)
+
+struct rain__thumbnail_job_ {
+	int slot;
+	uint32_t ticket;
+	/** path to load when pending, null when done. */
+	char *path;
+	/** RAIN_THUMBNAIL_SIZE^2 RGBA8 pixels when done, null if loading failed. */
+	uint8_t *pixels;
+};
+
+/** a fixed-size RGBA8 atlas of downscaled images, decoded on a worker thread.
+    slot allocation (and eviction) is up to the caller. */
+struct rain_thumbnails {
+	bool started;
+	struct rain_texture atlas;
+	/** ticket of the last request per slot, guarded by `lock`. */
+	uint32_t requested_tickets[RAIN_THUMBNAIL_SLOTS];
+	/** ticket and update number of the thumbnail on its way into the
+	    atlas per slot, main thread. */
+	uint32_t uploading_tickets[RAIN_THUMBNAIL_SLOTS];
+	uint64_t uploading_serials[RAIN_THUMBNAIL_SLOTS];
+	/** ticket of the thumbnail drawn from the atlas per slot, 0 if none.
+	    main thread, only set once its update is recorded. */
+	uint32_t ready_tickets[RAIN_THUMBNAIL_SLOTS];
+
+	thrd_t worker;
+	mtx_t lock;
+	cnd_t wake;
+	bool quit;
+	struct rain__thumbnail_job_ *pending;
+	size_t pending_count, pending_capacity;
+	struct rain__thumbnail_job_ *done;
+	size_t done_count, done_capacity;
+};
+
+void rain_thumbnails_init(struct rain_thumbnails *this_);
+void rain_thumbnails_deinit(struct rain_thumbnails *this_);
+
+/** (re)load the image at `path` into `slot`. the most recent request for a slot wins.
+    `ticket` must not be 0. */
+void rain_thumbnails_request(
+	struct rain_thumbnails *RAIN_RESTRICT this_,
+	int slot,
+	uint32_t ticket,
+	const char *RAIN_RESTRICT path
+);
+
+/** queue finished thumbnails into the atlas and mark the ones whose
+    update has been recorded ready. call once per frame on the main
+    thread, before `rain_texture_uploads_flush`. */
+void rain_thumbnails_update(struct rain_thumbnails *this_);
+
+#endif // RAIN__THUMBNAILS_H_
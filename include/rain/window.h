@@ -1,5 +1,6 @@
 #ifndef RAIN__WINDOW_H_
 #define RAIN__WINDOW_H_
+#include <stdint.h>
 #include <rain/compat.h>
 
 struct rain_window {
@@ -13,9 +14,28 @@ void rain_window_init(
 	int width, int height
 );
 
-/** end frame. */
+/** end frame, same as `rain_window_swap` then `rain_window_poll`. */
 void rain_window_frame(struct rain_window *this_);
 
+/** present. must be called where the context is current. */
+void rain_window_swap(struct rain_window *this_);
+
+/** process pending events. main thread only. */
+void rain_window_poll(struct rain_window *this_);
+
+/** make the GL context current on (or release it from) the calling thread. */
+void rain_window_make_current(struct rain_window *this_, bool current);
+
+/** block until an event arrives or `timeout` seconds pass.
+    used instead of polling in `rain_window_frame` while idle. */
+void rain_window_wait(struct rain_window *this_, double timeout);
+
+/** wake up `rain_window_wait`. safe to call from any thread. */
+void rain_window_wake(struct rain_window *this_);
+
+/** true if there was input or a wake up since the last call. */
+bool rain_window_take_events(struct rain_window *this_);
+
 /** should the window close (loop condition). */
 bool rain_window_should_close(struct rain_window *this_);
 
@@ -32,12 +52,19 @@ void rain_window_get_fb_size(
 /** deinitialize window. */
 void rain_window_deinit(struct rain_window *this_);
 
-/** get time since window creation (TODO: revise) in seconds. */
-float rain_window_get_time(struct rain_window *this_);
+/** monotonic time since the window was created, in nanoseconds. */
+uint64_t rain_window_get_time_ns(struct rain_window *this_);
 
 /** return true if a key is pressed down. */
 bool rain_window_is_key_down(struct rain_window *this_, int keycode);
 
+/** whether each key below `count` is pressed down, indexed by keycode. */
+void rain_window_get_keys(
+	struct rain_window *RAIN_RESTRICT this_,
+	bool *RAIN_RESTRICT out_down,
+	int count
+);
+
 const char *rain_window_get_title(const struct rain_window *this_);
 
 void rain_window_set_title(
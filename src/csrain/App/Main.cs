@@ -18,6 +18,19 @@ class Game : IApp
 	{
 	}
 
+	public void FixedUpdate(float fixedDeltaTime)
+	{
+	}
+
+	public void LateUpdate(float deltaTime)
+	{
+	}
+
+	public void Resize(int width, int height)
+	{
+		if (height > 0) Camera.Active.Aspect = width /(float) height;
+	}
+
 	public void Render()
 	{
 		// Renderer.Active.RenderTexturedQuad(
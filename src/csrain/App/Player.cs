@@ -1,6 +1,7 @@
 using System.Numerics;
 using RainEngine;
 
+[ParallelUpdate]
 class Player : Component
 {
 	public float Speed = 1.0f;
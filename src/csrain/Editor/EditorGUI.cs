@@ -1,6 +1,7 @@
 using System;
 using System.Collections.Generic;
 using System.IO;
+using System.Linq.Expressions;
 using System.Numerics;
 using System.Reflection;
 using System.Text;
@@ -35,27 +36,30 @@ static class GUIUtils
 class ValueMember
 {
 	public readonly MemberInfo Info;
-	public ValueMember(MemberInfo info) => Info = info;
+	/// Inspector label, <c>GUIUtils.CamelToTitle(Name)</c>.
+	public readonly string Label;
+	/// ImGui id for widgets that need one besides the label.
+	public readonly string Id;
+
+	public ValueMember(MemberInfo info)
+	{
+		Info = info;
+		Label = GUIUtils.CamelToTitle(info.Name);
+		Id = $"##{info.Name}";
+	}
 
 	public string Name => Info.Name;
 
-	public object GetValue(object obj) => Info switch
+	/// Has a value per object, the accessors of ValueMember<T> need one.
+	/// Static, const and indexed members don't.
+	public bool IsInstance => Info switch
 	{
-		FieldInfo fieldInfo => fieldInfo.GetValue(obj),
-		PropertyInfo propertyInfo => propertyInfo.GetValue(obj),
+		FieldInfo fieldInfo => !fieldInfo.IsStatic && !fieldInfo.IsLiteral,
+		PropertyInfo propertyInfo => propertyInfo.GetIndexParameters().Length == 0
+			&& !(propertyInfo.GetGetMethod(true) ?? propertyInfo.GetSetMethod(true))!.IsStatic,
 		_ => throw new InvalidOperationException()
 	};
 
-	public void SetValue(object obj, object value)
-	{
-		switch (Info)
-		{
-			case FieldInfo fieldInfo: fieldInfo.SetValue(obj, value); break;
-			case PropertyInfo propertyInfo: propertyInfo.SetValue(obj, value); break;
-			default: throw new InvalidOperationException();
-		};
-	}
-
 	public bool IsReadable => Info switch
 	{
 		FieldInfo fieldInfo => fieldInfo.IsPublic,
@@ -78,7 +82,31 @@ class ValueMember
 	};
 }
 
-public class EditorGUI {
+/// A member with compiled, strongly-typed accessors, so reading and writing it
+/// doesn't box or go through reflection.
+class ValueMember<T> : ValueMember
+{
+	public readonly Func<object, T> GetValue;
+	/// Null if the member isn't writeable.
+	public readonly Action<object, T>? SetValue;
+
+	public ValueMember(MemberInfo info) : base(info)
+	{
+		var obj = Expression.Parameter(typeof(object), "obj");
+		var access = Expression.MakeMemberAccess(Expression.Convert(obj, info.DeclaringType), info);
+		GetValue = Expression.Lambda<Func<object, T>>(access, obj).Compile();
+
+		if (IsWriteable)
+		{
+			var value = Expression.Parameter(typeof(T), "value");
+			SetValue = Expression.Lambda<Action<object, T>>(
+				Expression.Assign(access, value), obj, value
+			).Compile();
+		}
+	}
+}
+
+public class EditorGUI : IDisposable {
 	private Entity? _Selected;
 
 	public static float DragSpeed = 0.3f;
@@ -86,27 +114,27 @@ public class EditorGUI {
 
 	private static void DragFloat(ValueMember m, ref float value)
 	{
-		ImGui.DragFloat(GUIUtils.CamelToTitle(m.Name), ref value, DragSpeed, 0.0f, 0.0f, NumericFormat);
+		ImGui.DragFloat(m.Label, ref value, DragSpeed, 0.0f, 0.0f, NumericFormat);
 	}
 
 	private static void DragFloat(ValueMember m, ref Vector2 value)
 	{
-		ImGui.DragFloat2(GUIUtils.CamelToTitle(m.Name), ref value, DragSpeed, 0.0f, 0.0f, NumericFormat);
+		ImGui.DragFloat2(m.Label, ref value, DragSpeed, 0.0f, 0.0f, NumericFormat);
 	}
 
 	private static void DragFloat(ValueMember m, ref Vector3 value)
 	{
-		ImGui.DragFloat3(GUIUtils.CamelToTitle(m.Name), ref value, DragSpeed, 0.0f, 0.0f, NumericFormat);
+		ImGui.DragFloat3(m.Label, ref value, DragSpeed, 0.0f, 0.0f, NumericFormat);
 	}
 
 	private static void DragFloat(ValueMember m, ref Vector4 value)
 	{
-		ImGui.DragFloat4(GUIUtils.CamelToTitle(m.Name), ref value, DragSpeed, 0.0f, 0.0f, NumericFormat);
+		ImGui.DragFloat4(m.Label, ref value, DragSpeed, 0.0f, 0.0f, NumericFormat);
 	}
 
 	private static void DragFloat(ValueMember m, ref Quaternion value)
 	{
-		ImGuiUtil.DragFloatQ(GUIUtils.CamelToTitle(m.Name), ref value, DragSpeed, 0.0f, 0.0f, NumericFormat);
+		ImGuiUtil.DragFloatQ(m.Label, ref value, DragSpeed, 0.0f, 0.0f, NumericFormat);
 	}
 
 	private Asset<Texture>? _OpenTextureSelector()
@@ -139,7 +167,7 @@ public class EditorGUI {
 		bool clicked;
 		if (value.Get() != null)
 		{
-			clicked = ImGuiUtil.ImageButton($"{m.Name}_ImageButton", value.Get()!, 64.0f);
+			clicked = ImGuiUtil.ImageButton(m.Id, value.Get()!, 64.0f);
 		}
 		else
 		{
@@ -169,13 +197,24 @@ public class EditorGUI {
 			ImGui.EndDragDropTarget();
 		}
 		int id = (int)value.ID.Raw;
-		if (id != 0) ImGui.InputInt(GUIUtils.CamelToTitle(m.Name), ref id);
-		if (AssetManager.Active.Assets.ContainsKey((ulong)id))
+		if (id != 0 && ImGui.InputInt(m.Label, ref id)
+			&& id != (int)value.ID.Raw
+			&& AssetManager.Active.Assets.ContainsKey((ulong)id))
 			value = new(new((ulong)id));
 	}
 
+	/// Set when the inspector wrote to a component, cleared by the owner.
+	public bool SceneModified;
+
 	public EditorGUI()
 	{
+		unsafe
+		{
+			_EntityListClipper = new(ImGuiNative.ImGuiListClipper_ImGuiListClipper());
+			_AssetBrowserClipper = new(ImGuiNative.ImGuiListClipper_ImGuiListClipper());
+		}
+		AssetManager.Active.AssetReloaded += (id, _) => Thumbnails.Invalidate(id);
+
 		AddMemberEditor<float>((ValueMember m, ref float value, object _) => DragFloat(m, ref value));
 		AddMemberEditor<Vector2>((ValueMember m, ref Vector2 value, object _) => DragFloat(m, ref value));
 		AddMemberEditor<Vector3>((ValueMember m, ref Vector3 value, object _) => DragFloat(m, ref value));
@@ -184,6 +223,13 @@ public class EditorGUI {
 		AddMemberEditor<Asset<Texture>>(_TextureAssetMemberEditor);
 	}
 
+	/// The clippers are allocated by ImGui.
+	public void Dispose()
+	{
+		_EntityListClipper.Destroy();
+		_AssetBrowserClipper.Destroy();
+	}
+
 	private void RenderWindow(string name, Action content) {
 		if (ImGui.Begin(name)) content();
 		ImGui.End();
@@ -193,36 +239,118 @@ public class EditorGUI {
 		RenderWindow("Inspector", Inspector);
 		RenderWindow("Scene", EntityList);
 		RenderWindow("Asset Browser", AssetBrowser);
+		RenderWindow("Profiler", ProfilerPanel);
 	}
 
-	private void EntityList()
+	private void ProfilerPanel()
 	{
-		foreach (var entity in Scene.Active.Entities) {
-			bool isSelected = (_Selected == entity);
-
-			bool isOpen = ImGui.TreeNodeEx(
-				new IntPtr(entity.Id),
-				isSelected ? ImGuiTreeNodeFlags.Selected : 0,
-				entity.Name
-			);
+		var frame = Profiler.LastFrame;
+		ImGui.Text($"Mode: {Profiler.Mode}");
+		if (Profiler.Mode == ProfilerMode.Off)
+			ImGui.TextDisabled("Set RAIN_PROFILER=count or sampled to track allocations.");
+		else
+			ImGui.Text($"Allocations: {frame.AllocCount} ({frame.AllocBytes} B) last frame");
+		ImGui.Text($"GC: {frame.GCCount} ({frame.GCMajorCount} major), {frame.GCPauseMs:F3} ms paused last frame");
+		ImGui.Text($"Longest GC pause: {Profiler.MaxGCPauseMs:F3} ms");
+		ImGui.Text($"GPU state changes: {Renderer.StateChanges} last frame");
+
+		var graphSize = new Vector2(ImGui.GetContentRegionAvail().X, 48);
+		ImGui.PlotHistogram("##Allocations", ref Profiler.AllocCountHistory[0],
+			Profiler.HistoryLength, Profiler.HistoryOffset, "allocations/frame",
+			0, float.MaxValue, graphSize);
+		ImGui.PlotHistogram("##GCPauses", ref Profiler.GCPauseHistory[0],
+			Profiler.HistoryLength, Profiler.HistoryOffset, "GC pause (ms)",
+			0, float.MaxValue, graphSize);
+
+		if (Profiler.Mode != ProfilerMode.Sampled)
+		{
+			ImGui.TextDisabled("Set RAIN_PROFILER=sampled for a per-type breakdown.");
+			return;
+		}
 
-			if (ImGui.IsItemClicked())
+		if (ImGui.Button("Reset")) Profiler.ResetSampledTypes();
+		if (ImGui.BeginTable("ProfilerTypes", 3, ImGuiTableFlags.Borders | ImGuiTableFlags.RowBg))
+		{
+			ImGui.TableSetupColumn("Type");
+			ImGui.TableSetupColumn("Allocations (est.)");
+			ImGui.TableSetupColumn("Bytes (est.)");
+			ImGui.TableHeadersRow();
+			var types = Profiler.GetSampledTypes();
+			for (int i = 0; i < types.Count; ++i)
 			{
-				_Selected = entity;
-				Debug.Log("Selected new entity");
-				// _SelectedComponent = null;
+				var type = types.Array![types.Offset + i];
+				ImGui.TableNextRow();
+				ImGui.TableNextColumn();
+				ImGui.Text(type.Name);
+				ImGui.TableNextColumn();
+				ImGui.Text($"{type.EstimatedCount}");
+				ImGui.TableNextColumn();
+				ImGui.Text($"{type.EstimatedBytes}");
 			}
+			ImGui.EndTable();
+		}
+	}
+
+	private struct EntityListRow
+	{
+		public Entity Entity;
+		public IntPtr TreeId;
+	}
+
+	/// Scenes only ever append entities, so rows are appended as they are
+	/// created and only rebuilt for another scene. Only the visible rows are submitted.
+	private readonly List<EntityListRow> _EntityListRows = new();
+	private Scene? _EntityListScene;
+	private ImGuiListClipperPtr _EntityListClipper;
+
+	private void EntityList()
+	{
+		var scene = Scene.Active;
+		if (scene != _EntityListScene)
+		{
+			_EntityListRows.Clear();
+			_EntityListScene = scene;
+		}
+		for (int i = _EntityListRows.Count; i < scene.Entities.Count; ++i)
+		{
+			var e = scene.Entities[i];
+			_EntityListRows.Add(new() { Entity = e, TreeId = new IntPtr(e.Id) });
+		}
 
-			if (isOpen)
+		var clipper = _EntityListClipper;
+		clipper.Begin(_EntityListRows.Count);
+		while (clipper.Step())
+		{
+			for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
 			{
-				ImGui.TreePop();
+				var row = _EntityListRows[i];
+				var entity = row.Entity;
+				bool isSelected = (_Selected == entity);
+
+				ImGui.TreeNodeEx(
+					row.TreeId,
+					ImGuiTreeNodeFlags.Leaf | ImGuiTreeNodeFlags.NoTreePushOnOpen
+						| ImGuiTreeNodeFlags.SpanAvailWidth
+						| (isSelected ? ImGuiTreeNodeFlags.Selected : 0),
+					entity.Name
+				);
+
+				if (ImGui.IsItemClicked())
+				{
+					_Selected = entity;
+					Debug.Log("Selected new entity");
+					// _SelectedComponent = null;
+				}
 			}
 		}
+		clipper.End();
 	}
 
-
 	private bool _FileLikeIconButton(
-		Texture thumbnail,
+		string id,
+		IntPtr texture,
+		Vector2 uv0,
+		Vector2 uv1,
 		string name,
 		bool dragDrop = false,
 		string payloadType = "",
@@ -233,8 +361,9 @@ public class EditorGUI {
 		ImGui.PushStyleColor(ImGuiCol.Button, new Vector4(0, 0, 0, 0));
 
 		bool res = false;
-		ImGuiUtil.ImageButton($"{name}_ImageButton",
-			thumbnail, AssetBrowserThumbnailSize);
+		ImGui.ImageButton(id, texture,
+			new Vector2(AssetBrowserThumbnailSize, AssetBrowserThumbnailSize),
+			uv0, uv1, new(0, 0, 0, 0), new(1, 1, 1, 1));
 
 		if (ImGui.IsItemHovered() && ImGui.IsMouseDoubleClicked(0))
 		{
@@ -249,17 +378,72 @@ public class EditorGUI {
 			ImGui.EndDragDropSource();
 		}
 
-		ImGui.TextWrapped($"{name}");
+		// not wrapped, the clipper needs rows of the same height.
+		ImGui.TextUnformatted(name);
 		ImGui.NextColumn();
 
 		return res;
 	}
 
+	private bool _FileLikeIconButton(string id, Texture icon, string name) =>
+		_FileLikeIconButton(id, icon._Handle, new(0, 1), new(1, 0), name);
+
+	private readonly Asset<Texture> _FolderIcon = AssetManager.Active.Find<Texture>("icons/folder.png");
+	private readonly Asset<Texture> _ImageIcon = AssetManager.Active.Find<Texture>("icons/image.png");
+
 	private int AssetBrowserPadding = 16;
 	private int AssetBrowserThumbnailSize = 72;
 
 	private string AssetBrowserCurrentPath = "";
 
+	private struct AssetBrowserEntry
+	{
+		public string Name;
+		public string ButtonId;
+		/// Null for assets.
+		public AssetDirectory? Directory;
+		public AssetID AssetID;
+		/// Image file to make a thumbnail from, if any.
+		public string? ThumbnailPath;
+	}
+
+	/// Subdirectories first, then the assets of the current directory.
+	/// Rebuilt from the directory tree whenever the directory changes.
+	private List<AssetBrowserEntry> _AssetBrowserEntries = new();
+	private AssetDirectory? _AssetBrowserDirectory;
+	private int _AssetBrowserVersion;
+	private ImGuiListClipperPtr _AssetBrowserClipper;
+
+	private void _RebuildAssetBrowserEntries(AssetDirectory directory)
+	{
+		_AssetBrowserEntries.Clear();
+		foreach (var child in directory.Children.Values)
+		{
+			_AssetBrowserEntries.Add(new()
+			{
+				Name = child.Name,
+				ButtonId = $"{child.Path}_ImageButton",
+				Directory = child
+			});
+		}
+		foreach (var id in directory.Assets)
+		{
+			var info = AssetManager.Active.Assets[id.Raw];
+			string? thumbnailPath = null;
+			if (info.Data is Texture && info.Source.TryGetProperty("path", out var path))
+				thumbnailPath = path.GetString();
+			_AssetBrowserEntries.Add(new()
+			{
+				Name = Path.GetFileName(info.Name),
+				ButtonId = $"{info.Name}_ImageButton",
+				AssetID = id,
+				ThumbnailPath = thumbnailPath
+			});
+		}
+		_AssetBrowserDirectory = directory;
+		_AssetBrowserVersion = directory.Version;
+	}
+
 	private void AssetBrowser()
 	{
 		float cellSize = AssetBrowserThumbnailSize + AssetBrowserPadding;
@@ -268,111 +452,181 @@ public class EditorGUI {
 		int columnCount = (int)(panelWidth / cellSize);
 		if (columnCount < 1) columnCount = 1;
 
-
-		HashSet<string> directories = new();
-
-		foreach (var assetName in AssetManager.Active.AssetNames)
+		// the directory disappears if all of its assets are unloaded.
+		var directory = AssetManager.Active.FindDirectory(AssetBrowserCurrentPath);
+		if (directory == null)
 		{
-			string dirname = Path.GetDirectoryName(assetName.Key);
-			if (directories.Contains(dirname) || dirname == "") continue;
-			string parentDirname = Path.GetDirectoryName(dirname);
-			if (parentDirname != AssetBrowserCurrentPath) continue;
-			directories.Add(dirname);
+			AssetBrowserCurrentPath = "";
+			directory = AssetManager.Active.RootDirectory;
 		}
+		if (directory != _AssetBrowserDirectory || directory.Version != _AssetBrowserVersion)
+			_RebuildAssetBrowserEntries(directory);
 
-		ImGui.Columns(columnCount, "#AssetBrowser", false);
+		// ".." is the first cell outside of the root.
+		int firstEntry = directory.Parent != null ? -1 : 0;
+		int cellCount = _AssetBrowserEntries.Count - firstEntry;
+		int rowCount = (cellCount + columnCount - 1) / columnCount;
 
-		if (AssetBrowserCurrentPath != "")
-			if (_FileLikeIconButton(
-				AssetManager.Active.Get<Texture>("icons/folder.png")!,
-				".."
-			))
-			{
-				AssetBrowserCurrentPath = Path.GetDirectoryName(AssetBrowserCurrentPath);
-				return;
-			}
+		ImGui.Columns(columnCount, "#AssetBrowser", false);
 
-		foreach (var directory in directories)
+		var clipper = _AssetBrowserClipper;
+		clipper.Begin(rowCount);
+		while (clipper.Step())
 		{
-			if (_FileLikeIconButton(
-				AssetManager.Active.Get<Texture>("icons/folder.png")!,
-				directory
-			))
+			for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row)
 			{
-				AssetBrowserCurrentPath = directory;
-				return;
+				int end = Math.Min(firstEntry + (row + 1) * columnCount, _AssetBrowserEntries.Count);
+				for (int i = firstEntry + row * columnCount; i < end; ++i)
+				{
+					if (_AssetBrowserCell(directory, i))
+					{
+						clipper.End();
+						ImGui.Columns(1);
+						return;
+					}
+				}
 			}
 		}
+		clipper.End();
+		ImGui.Columns(1);
 
-		foreach (var asset in AssetManager.Active.Assets)
-		{
-			string dirname = Path.GetDirectoryName(asset.Value.Name);
-			string filename = Path.GetFileName(asset.Value.Name);
-			if (dirname != AssetBrowserCurrentPath) continue;
+		// ImGui.SliderInt("Thumbnail Size", ref assetBrowserThumbnailSize, 16, 512);
+		// ImGui.SliderInt("Padding", ref assetBrowserPadding, 0, 32);
+	}
 
-			Texture thumbnail;
-			if (asset.Value.Data.GetType() == typeof(Texture))
-			{
-				thumbnail = (Texture)asset.Value.Data;
-			}
-			else
+	/// Returns true if the current path changed.
+	private bool _AssetBrowserCell(AssetDirectory directory, int index)
+	{
+		if (index < 0)
+		{
+			if (_FileLikeIconButton(".._ImageButton", _FolderIcon.Get()!, ".."))
 			{
-				thumbnail = AssetManager.Active.Get<Texture>("icons/image.png")!;
+				AssetBrowserCurrentPath = directory.Parent!.Path;
+				return true;
 			}
+			return false;
+		}
 
-			IntPtr data;
-			unsafe
+		var entry = _AssetBrowserEntries[index];
+		if (entry.Directory != null)
+		{
+			if (_FileLikeIconButton(entry.ButtonId, _FolderIcon.Get()!, entry.Name))
 			{
-				ulong id = asset.Key;
-				data = new(&id);
+				AssetBrowserCurrentPath = entry.Directory.Path;
+				return true;
 			}
+			return false;
+		}
 
-			_FileLikeIconButton(
-				thumbnail,
-				filename,
-				true,
-				"AssetBrowserItem",
-				data,
-				sizeof(ulong)
-			);
+		IntPtr texture;
+		Vector2 uv0, uv1;
+		if (entry.ThumbnailPath != null
+			&& Thumbnails.TryGet(entry.AssetID, entry.ThumbnailPath, out uv0, out uv1))
+		{
+			texture = Thumbnails.AtlasHandle;
+		}
+		else
+		{
+			texture = _ImageIcon.Get()!._Handle;
+			(uv0, uv1) = (new(0, 1), new(1, 0));
 		}
 
-		// ImGui.SliderInt("Thumbnail Size", ref assetBrowserThumbnailSize, 16, 512);
-		// ImGui.SliderInt("Padding", ref assetBrowserPadding, 0, 32);
-	}
+		IntPtr payload;
+		unsafe
+		{
+			ulong id = entry.AssetID.Raw;
+			payload = new(&id);
+		}
 
-	private void _MemberEditor(ValueMember valueMember, object component)
-	{
-		if (!_MemberEditors.ContainsKey(valueMember.ValueType)) return;
-		ImGui.BeginDisabled(!valueMember.IsWriteable);
-		_MemberEditors[valueMember.ValueType](valueMember, component);
-		ImGui.EndDisabled();
+		_FileLikeIconButton(
+			entry.ButtonId,
+			texture, uv0, uv1,
+			entry.Name,
+			true,
+			"AssetBrowserItem",
+			payload,
+			sizeof(ulong)
+		);
+		return false;
 	}
 
-	private Dictionary<Type, Action<ValueMember, object>> _MemberEditors = new();
+	/// Inspector row builders, by member type.
+	private Dictionary<Type, Func<MemberInfo, Action<object>>> _MemberEditors = new();
 
 	delegate void MemberEditor<T>(ValueMember member, ref T value, object component);
 
 	void AddMemberEditor<T>(MemberEditor<T> editor) =>
-		_MemberEditors.Add(typeof(T), (valueMember, component) =>
+		_MemberEditors.Add(typeof(T), info =>
 		{
-			var value = (T)valueMember.GetValue(component);
+			var valueMember = new ValueMember<T>(info);
+			var comparer = EqualityComparer<T>.Default;
+			return component =>
+			{
+				var value = valueMember.GetValue(component);
+				var oldValue = value;
 
-			editor(valueMember, ref value, component);
-			
-			if (valueMember.IsWriteable) valueMember.SetValue(component, value!);
+				ImGui.BeginDisabled(valueMember.SetValue == null);
+				editor(valueMember, ref value, component);
+				ImGui.EndDisabled();
+
+				if (valueMember.SetValue != null && !comparer.Equals(oldValue, value))
+				{
+					valueMember.SetValue(component, value);
+					SceneModified = true;
+				}
+			};
 		});
 
+	/// Everything the inspector needs for a component type, built once per type.
+	private class InspectorLayout
+	{
+		public string Title = "";
+		public Action<object>[] Rows = Array.Empty<Action<object>>();
+	}
+
+	private Dictionary<Type, InspectorLayout> _InspectorLayouts = new();
+
+	private InspectorLayout _GetInspectorLayout(Type type)
+	{
+		if (_InspectorLayouts.TryGetValue(type, out var layout)) return layout;
+
+		List<Action<object>> rows = new();
+		foreach (var member in type.GetMembers())
+		{
+			if (member.MemberType != MemberTypes.Field
+			&& member.MemberType != MemberTypes.Property) continue;
+			ValueMember valueMember = new(member);
+			if (!valueMember.IsInstance || !valueMember.IsReadable) continue;
+			if (!_MemberEditors.TryGetValue(valueMember.ValueType, out var makeRow)) continue;
+			rows.Add(makeRow(member));
+		}
+
+		layout = new() { Title = type.Name, Rows = rows.ToArray() };
+		_InspectorLayouts.Add(type, layout);
+		return layout;
+	}
+
+	private Entity? _InspectorTitleEntity;
+	private string? _InspectorTitleName;
+	private string _InspectorTitle = "";
+
 	private void Inspector()
 	{
 		if (_Selected?.Scene != Scene.Active) _Selected = null;
 		if (_Selected != null) {
-			ImGui.Text($"Entity #{_Selected.Id}: {_Selected.Name}");
+			if (_InspectorTitleEntity != _Selected || !ReferenceEquals(_InspectorTitleName, _Selected.Name))
+			{
+				_InspectorTitleEntity = _Selected;
+				_InspectorTitleName = _Selected.Name;
+				_InspectorTitle = $"Entity #{_Selected.Id}: {_Selected.Name}";
+			}
+			ImGui.Text(_InspectorTitle);
 
 			for (int i = 0; i < _Selected.Components.Count; ++i) {
 				var flags = ImGuiTreeNodeFlags.DefaultOpen;
 
 				var component = _Selected.Components[i];
+				var layout = _GetInspectorLayout(component.GetType());
 				// bool isSelected = (_SelectedComponent == i);
 
 				// if (isSelected) flags |= ImGuiTreeNodeFlags.Selected;
@@ -380,22 +634,14 @@ public class EditorGUI {
 				var isOpen = ImGui.TreeNodeEx(
 					new IntPtr(i),
 					flags,
-					component.GetType().Name
+					layout.Title
 				);
 
 				// if (ImGui.IsItemClicked()) _SelectedComponent = i;
 
 				if (isOpen)
 				{
-					var members = component.GetType().GetMembers();
-					foreach (var member in members) {
-						if (member.MemberType != System.Reflection.MemberTypes.Field
-						&& member.MemberType != System.Reflection.MemberTypes.Property) continue;
-						ValueMember valueMember = new(member);
-						if (!valueMember.IsReadable) continue;
-
-						_MemberEditor(valueMember, component);
-					}
+					foreach (var row in layout.Rows) row(component);
 					ImGui.TreePop();
 				}
 			}
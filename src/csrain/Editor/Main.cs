@@ -7,9 +7,13 @@ class Editor : IApp
 	private Framebuffer _GameFramebuffer;
 	private RenderPass _GameRenderPass;
 	private EditorGUI _GUI;
+	private Asset<Texture> _PlayIcon, _PauseIcon;
 
 	public bool IsPlaying = false;
 
+	/// The game viewport is only re-rendered while playing or after a change.
+	private bool _GameViewDirty = true;
+
 	public Editor()
 	{
 		Window.Active.Title = "Rain Engine Editor";
@@ -18,8 +22,17 @@ class Editor : IApp
 		_GameRenderPass = new(_GameFramebuffer);
 
 		AssetManager.Active.LoadAllFromManifestFile("data/manifest.json");
+		_PlayIcon = AssetManager.Active.Find<Texture>("icons/play.png");
+		_PauseIcon = AssetManager.Active.Find<Texture>("icons/pause.png");
 		ReloadScene();
 		_GUI = new();
+
+		AssetManager.Active.AssetReloaded += (_, _) =>
+		{
+			_GameViewDirty = true;
+			Engine.Wake();
+		};
+		Engine.AllowIdle = true;
 	}
 
 	public void ReloadScene()
@@ -31,6 +44,7 @@ class Editor : IApp
 		// 	new SpriteComponent(AssetManager.Active.Get<Texture>(new(1)))
 		// );
 		Camera.Active.Position = new(0.0f, 0.0f, -3.0f);
+		_GameViewDirty = true;
 	}
 
 	public void Entry()
@@ -40,12 +54,14 @@ class Editor : IApp
 	private void StartPlaying()
 	{
 		IsPlaying = true;
+		Engine.AllowIdle = false;
 		Scene.Active.OnCreate();
 	}
 
 	private void StopPlaying()
 	{
 		IsPlaying = false;
+		Engine.AllowIdle = true;
 		// Scene.Active.OnDestroy();
 		ReloadScene();
 	}
@@ -61,12 +77,45 @@ class Editor : IApp
 		}
 	}
 
+	public void FixedUpdate(float fixedDeltaTime)
+	{
+		if (IsPlaying) Scene.Active.OnFixedUpdate(fixedDeltaTime);
+	}
+
+	public void LateUpdate(float deltaTime)
+	{
+		if (IsPlaying) Scene.Active.OnLateUpdate(deltaTime);
+	}
+
+	public void Resize(int width, int height)
+	{
+		// minimized.
+		if (width <= 0 || height <= 0) return;
+		var size = new Extent2((ulong)width / 2, (ulong)height / 2);
+		if (size.Width == _GameFramebuffer.Size.Width && size.Height == _GameFramebuffer.Size.Height) return;
+
+		// the old targets go back to the pool, resizing back and forth reuses them.
+		_GameRenderPass.Dispose();
+		_GameFramebuffer.Dispose();
+		_GameFramebuffer = new(size);
+		_GameRenderPass = new(_GameFramebuffer);
+		_GameViewDirty = true;
+	}
+
+	private static readonly string[] _DebugViewNames = { "Shaded", "Overdraw", "Batches", "State changes" };
+
 	private bool _ShouldRender = true;
 	public void Render()
 	{
-		Renderer.BeginPass(_GameRenderPass, new(0.1f, 0.2f, 0.3f, 1.0f));
-		Scene.Active.OnRender();
-		Renderer.EndPass();
+		// the framebuffer keeps the last frame otherwise.
+		if (IsPlaying || _GameViewDirty || _GUI.SceneModified)
+		{
+			Renderer.BeginPass(_GameRenderPass, new(0.1f, 0.2f, 0.3f, 1.0f));
+			Scene.Active.OnRender();
+			Renderer.EndPass();
+			_GameViewDirty = false;
+			_GUI.SceneModified = false;
+		}
 
 		Renderer.BeginPass(new(0.5f, 0.4f, 0.3f, 1.0f));
 		RainImGui.BeginRender();
@@ -81,20 +130,28 @@ class Editor : IApp
 		if (ImGui.Begin("Viewport"))
 		{
 			_ViewportWasFocused = ImGui.IsWindowFocused();
-			var icon = AssetManager.Active.Get<Texture>(
-				IsPlaying ? "icons/pause.png" : "icons/play.png"
-			)!;
+			var icon = (IsPlaying ? _PauseIcon : _PlayIcon).Get()!;
 			if (ImGuiUtil.ImageButton("PlayButton", icon, new Vector2(16, 16)))
 			{
 				if (IsPlaying) StopPlaying();
 				else StartPlaying();
 			}
+			ImGui.SameLine();
+			int debugView = (int)Renderer.DebugView;
+			if (ImGui.Combo("View", ref debugView, _DebugViewNames, _DebugViewNames.Length))
+			{
+				Renderer.DebugView = (RendererDebugView)debugView;
+				_GameViewDirty = true;
+			}
+			ImGui.SameLine();
+			ImGui.Checkbox("Stats", ref RendererStatsOverlay.Visible);
 			ImGuiUtil.Image(_GameFramebuffer.ColorTexture);
 		}
 		ImGui.End();
 
 		ImGui.ShowDemoWindow();
 		_GUI.Render();
+		RendererStatsOverlay.Render();
 
 		RainImGui.EndRender();
 
@@ -104,6 +161,9 @@ class Editor : IApp
 	public void Destroy()
 	{
 		SceneAsset.SaveToFile(SceneManager.ActiveScene, "data/scene1.json", true);
+		_GameRenderPass.Dispose();
+		_GameFramebuffer.Dispose();
+		_GUI.Dispose();
 	}
 }
 
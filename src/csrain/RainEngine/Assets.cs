@@ -30,6 +30,18 @@ namespace RainEngine
 		}
 	}
 
+	/// Index + generation into the native asset slot map (see rain/assets.h).
+	/// A default handle is never valid.
+	public struct AssetHandle
+	{
+		public readonly uint Index;
+		public readonly uint Generation;
+
+		public static AssetHandle Empty => new();
+
+		public override string ToString() => $"{{{Index}:{Generation}}}";
+	}
+
 	public class AssetBase
 	{
 		public readonly AssetID ID;
@@ -38,9 +50,26 @@ namespace RainEngine
 
 	public class Asset<T> : AssetBase
 	{
+		private AssetManager? _Manager;
+		private AssetHandle _Handle;
+
 		public Asset(AssetID id) : base(id) { }
 		public Asset() : this(AssetID.Empty) { }
-		public T? Get(AssetManager? manager = null) => ID.Get<T>(manager);
+
+		/// The ID is resolved to a handle on first use and after a reload,
+		/// otherwise this is a generation check and an array index.
+		public T? Get(AssetManager? manager = null)
+		{
+			if (manager == null) manager = AssetManager.Active;
+			if (_Manager != manager || !manager.IsValid(_Handle))
+			{
+				if (ID.Raw == 0) return default(T);
+				_Handle = manager.Resolve(ID);
+				_Manager = manager;
+			}
+			return (T?)manager.Deref(_Handle);
+		}
+
 		public override string ToString() => $"<{typeof(T).Name}>{ID}";
 	}
 
@@ -102,6 +131,23 @@ namespace RainEngine
 		}
 	}
 
+	/// A node of the directory tree of asset names, see AssetManager.RootDirectory.
+	public class AssetDirectory
+	{
+		/// Last path component, "" for the root.
+		public readonly string Name;
+		/// Full path, as used in asset names. "" for the root.
+		public readonly string Path;
+		public readonly AssetDirectory? Parent;
+		public readonly SortedDictionary<string, AssetDirectory> Children = new(StringComparer.Ordinal);
+		public readonly List<AssetID> Assets = new();
+		/// Bumped whenever Children or Assets change.
+		public int Version { get; internal set; }
+
+		internal AssetDirectory(string name, string path, AssetDirectory? parent) =>
+			(Name, Path, Parent) = (name, path, parent);
+	}
+
 	public class AssetManager
 	{
 		public static Dictionary<AssetType, IAssetLoader> Loaders = new Dictionary<AssetType, IAssetLoader>()
@@ -117,24 +163,107 @@ namespace RainEngine
 		{
 			public object Data;
 			public string Name;
+			public AssetHandle Handle;
+			/// The manifest entry, kept for reloading.
+			public JsonElement Source;
 		}
 
 		public Dictionary<ulong, AssetInfo> Assets = new();
 		public Dictionary<string, ulong> AssetNames = new();
 
+		/// Raised after an asset's data was replaced by Reload.
+		public event Action<AssetID, AssetInfo>? AssetReloaded;
+
+		public readonly AssetDirectory RootDirectory = new("", "", null);
+		private Dictionary<string, AssetDirectory> _Directories = new();
+
+		/// Null if no asset is in or below the directory.
+		public AssetDirectory? FindDirectory(string path) =>
+			path == "" ? RootDirectory : _Directories.TryGetValue(path, out var dir) ? dir : null;
+
+		private AssetDirectory _GetOrCreateDirectory(string path)
+		{
+			var found = FindDirectory(path);
+			if (found != null) return found;
+			var parent = _GetOrCreateDirectory(Path.GetDirectoryName(path));
+			AssetDirectory dir = new(Path.GetFileName(path), path, parent);
+			parent.Children.Add(dir.Name, dir);
+			parent.Version++;
+			_Directories.Add(path, dir);
+			return dir;
+		}
+
+		private void _AddToDirectoryTree(AssetID id, string name)
+		{
+			var dir = _GetOrCreateDirectory(Path.GetDirectoryName(name));
+			dir.Assets.Add(id);
+			dir.Version++;
+		}
+
+		private void _RemoveFromDirectoryTree(AssetID id, string name)
+		{
+			var dir = FindDirectory(Path.GetDirectoryName(name));
+			if (dir == null || !dir.Assets.Remove(id)) return;
+			dir.Version++;
+			// drop directories that became empty.
+			while (dir.Parent != null && dir.Assets.Count == 0 && dir.Children.Count == 0)
+			{
+				dir.Parent.Children.Remove(dir.Name);
+				dir.Parent.Version++;
+				_Directories.Remove(dir.Path);
+				dir = dir.Parent;
+			}
+		}
+
+		private static readonly unsafe uint* _Generations =
+			RainNative.Interop.Assets_GetGenerations();
+		private object?[] _Slots = new object?[64];
+
+		public unsafe bool IsValid(AssetHandle handle) =>
+			handle.Generation != 0 && _Generations[handle.Index] == handle.Generation;
+
+		public AssetHandle Resolve(AssetID id)
+		{
+			if (id.Raw == 0) return AssetHandle.Empty;
+			if (Assets.TryGetValue(id.Raw, out var info)) return info.Handle;
+			throw new Exception($"No such asset loaded: {id}.");
+		}
+
+		/// Null if the handle is stale or belongs to a different manager.
+		public object? Deref(AssetHandle handle) =>
+			IsValid(handle) && handle.Index < _Slots.Length ? _Slots[handle.Index] : null;
+
 		public T? Get<T>(AssetID id)
 		{
 			if (id.Raw == 0) return default(T);
-			if (Assets.ContainsKey(id.Raw)) return (T)Assets[id.Raw].Data;
+			if (Assets.TryGetValue(id.Raw, out var info)) return (T)info.Data;
 			throw new Exception($"No such asset loaded: {id}.");
 		}
 
 		public T? Get<T>(string name)
 		{
-			if (AssetNames.ContainsKey(name)) return (T)Assets[AssetNames[name]].Data;
+			if (AssetNames.TryGetValue(name, out var id)) return (T)Assets[id].Data;
 			throw new Exception($"No such asset loaded: '{name}'.");
 		}
 
+		/// Look up an asset by name once, for code that would otherwise call
+		/// <c>Get&lt;T&gt;(name)</c> every frame.
+		public Asset<T> Find<T>(string name)
+		{
+			if (AssetNames.TryGetValue(name, out var id)) return new(new(id));
+			throw new Exception($"No such asset loaded: '{name}'.");
+		}
+
+		private static IntPtr _NativeData(object obj) =>
+			obj is Texture texture ? texture._Handle : IntPtr.Zero;
+
+		private void _SetSlot(AssetHandle handle, object? obj)
+		{
+			if (handle.Index >= _Slots.Length)
+				Array.Resize(ref _Slots, Math.Max(_Slots.Length * 2, (int)handle.Index + 1));
+			_Slots[handle.Index] = obj;
+		}
+
 		public void LoadAllFromManifestJson(JsonElement manifest)
 		{
 			foreach (var assetJson in manifest.EnumerateArray())
@@ -147,11 +276,44 @@ namespace RainEngine
 					throw new Exception($"Duplicate Asset ID: {id}");
 				}
 				var (obj, _) = Loaders[type].Load(id, assetJson);
-				Assets[id.Raw] = new() { Data = obj, Name = name };
+				RainNative.Interop.Assets_Insert(_NativeData(obj), out var handle);
+				_SetSlot(handle, obj);
+				AssetInfo info = new() { Data = obj, Name = name, Handle = handle, Source = assetJson.Clone() };
+				Assets[id.Raw] = info;
 				AssetNames[name] = id.Raw;
+				_AddToDirectoryTree(id, name);
 			}
 		}
 
+		/// Load the asset again from its manifest entry.
+		/// Handles to the old data become stale.
+		public void Reload(AssetID id)
+		{
+			if (!Assets.TryGetValue(id.Raw, out var info))
+				throw new Exception($"No such asset loaded: {id}.");
+			var type = (AssetType)info.Source.GetProperty("type").GetUInt32();
+			var (obj, _) = Loaders[type].Load(id, info.Source);
+			if (!RainNative.Interop.Assets_Replace(ref info.Handle, _NativeData(obj)))
+				throw new Exception($"Stale asset handle: {id} {info.Handle}.");
+			_SetSlot(info.Handle, obj);
+			var old = info.Data;
+			info.Data = obj;
+			Assets[id.Raw] = info;
+			AssetReloaded?.Invoke(id, info);
+			(old as IDisposable)?.Dispose();
+		}
+
+		public void Unload(AssetID id)
+		{
+			if (!Assets.TryGetValue(id.Raw, out var info)) return;
+			RainNative.Interop.Assets_Remove(ref info.Handle);
+			_SetSlot(info.Handle, null);
+			Assets.Remove(id.Raw);
+			AssetNames.Remove(info.Name);
+			_RemoveFromDirectoryTree(id, info.Name);
+			(info.Data as IDisposable)?.Dispose();
+		}
+
 		public void LoadAllFromManifestFile(string path)
 		{
 			var doc = JsonDocument.Parse(File.ReadAllText(path));
@@ -50,11 +50,47 @@ namespace RainEngine
 		}
 	}
 
+	/// Lets the scene run OnUpdate of this component on job threads, in
+	/// parallel with the same component on other entities. OnUpdate may
+	/// then only touch its own entity's components and read input and
+	/// other state that doesn't change during the update. Anything else
+	/// (other entities, creating entities, shared collections) has to go
+	/// through `Scene.Defer`.
+	[AttributeUsage(AttributeTargets.Class, Inherited = true)]
+	public sealed class ParallelUpdateAttribute : Attribute { }
+
 	public class Component
 	{
 		[JsonIgnore]
 		public Entity? Bound { get; internal set; }
 
+		[Flags]
+		private enum _Traits { Cached = 1, ParallelUpdate = 2, Extract = 4 }
+		private static readonly Dictionary<Type, _Traits> _TypeTraits = new();
+
+		/// Scene.OnUpdate looks every component up on the main thread before
+		/// _UpdateParallel calls it from job threads, which only read the cache.
+		private _Traits _GetTraits()
+		{
+			var type = GetType();
+			if (!_TypeTraits.TryGetValue(type, out var traits))
+			{
+				traits = _Traits.Cached;
+				if (Attribute.IsDefined(type, typeof(ParallelUpdateAttribute), true))
+					traits |= _Traits.ParallelUpdate;
+				if (type.GetMethod(nameof(OnExtract))!.DeclaringType != typeof(Component))
+					traits |= _Traits.Extract;
+				_TypeTraits[type] = traits;
+			}
+			return traits;
+		}
+
+		/// Marked with [ParallelUpdate].
+		internal bool _ParallelUpdate => (_GetTraits() & _Traits.ParallelUpdate) != 0;
+
+		/// Overrides OnExtract.
+		internal bool _Extracts => (_GetTraits() & _Traits.Extract) != 0;
+
 		public void AddComponent<T>(T component) where T : Component
 		{
 			Bound?.AddComponent<T>(component);
@@ -67,9 +103,17 @@ namespace RainEngine
 
 		public virtual void OnCreate() { }
 		public virtual void OnUpdate(float deltaTime) { }
+		public virtual void OnFixedUpdate(float fixedDeltaTime) { }
+		public virtual void OnLateUpdate(float deltaTime) { }
 		public virtual void OnRender() { }
 		public virtual void OnDestroy() { }
 
+		/// Records what this component draws into `list`, on a job thread,
+		/// before OnRender runs. Like a [ParallelUpdate] OnUpdate it may only
+		/// read its own entity, assets and state that doesn't change while
+		/// rendering, and must not call Renderer directly.
+		public virtual void OnExtract(RenderList list) { }
+
 		[JsonIgnore]
 		public TransformComponent? Transform => Bound?.Transform;
 	}
@@ -91,8 +135,11 @@ namespace RainEngine
 		private Matrix4x4 _Matrix;
 
 		[JsonConstructor]
-		public TransformComponent(Vector3 position, Quaternion rotation, Vector3 scale) =>
+		public TransformComponent(Vector3 position, Quaternion rotation, Vector3 scale)
+		{
 			(_Position, _Rotation, _Scale, Parent, _Clean) = (position, rotation, scale, null, false);
+			_BeginFixedStep();
+		}
 		
 		[JsonIgnore]
 		public Matrix4x4 LocalTransform
@@ -116,6 +163,40 @@ namespace RainEngine
 		public Matrix4x4 GlobalTransform =>
 			Parent == null ? LocalTransform : LocalTransform * Parent.GlobalTransform;
 
+		/// Render between the last two fixed steps instead of at the current
+		/// state, for transforms moved in OnFixedUpdate.
+		public bool Interpolate { get; set; }
+
+		[JsonIgnore]
+		private Vector3 _PreviousPosition;
+		[JsonIgnore]
+		private Quaternion _PreviousRotation = Quaternion.Identity;
+		[JsonIgnore]
+		private Vector3 _PreviousScale = new(1, 1, 1);
+
+		internal void _BeginFixedStep() =>
+			(_PreviousPosition, _PreviousRotation, _PreviousScale) = (_Position, _Rotation, _Scale);
+
+		/// GlobalTransform as it should be drawn this frame, see Interpolate.
+		[JsonIgnore]
+		public Matrix4x4 RenderTransform
+		{
+			get
+			{
+				Matrix4x4 local = LocalTransform;
+				if (Interpolate)
+				{
+					float alpha = Time.InterpolationAlpha;
+					local
+						= Matrix4x4.CreateTranslation(Vector3.Lerp(_PreviousPosition, _Position, alpha))
+						* Matrix4x4.CreateFromQuaternion(Quaternion.Slerp(_PreviousRotation, _Rotation, alpha))
+						* Matrix4x4.CreateScale(Vector3.Lerp(_PreviousScale, _Scale, alpha))
+						;
+				}
+				return Parent == null ? local : local * Parent.RenderTransform;
+			}
+		}
+
 		public Vector3 Position
 		{
 			get => _Position;
@@ -135,6 +216,17 @@ namespace RainEngine
 		}
 	}
 
+	public enum SpriteAlpha
+	{
+		/// Opaque for untextured sprites with an opaque color, Blend otherwise.
+		Auto,
+		Opaque,
+		/// Opaque, with texels under half alpha discarded.
+		Cutout,
+		/// Alpha blended, back to front after the opaque sprites.
+		Blend,
+	}
+
 	public class SpriteComponent : Component {
 		public Vector4 Color { get; set; }
 		public Asset<Texture> Sprite { get; set; }
@@ -147,26 +239,51 @@ namespace RainEngine
 
 		public SpriteComponent(Asset<Texture> sprite) : this(new(1), sprite) {}
 
+		/// Higher layers cover lower ones whatever their Alpha, see SortKey.
+		public int Layer { get; set; }
+
+		/// Picks the builtin material when Material is null.
+		public SpriteAlpha Alpha { get; set; }
+
+		/// Null draws with a builtin material, see Alpha.
+		[JsonIgnore]
+		public Material? Material { get; set; }
+
+		private Material? _PickMaterial(Texture? texture)
+		{
+			if (Material != null)
+			{
+				// a textured material has nothing to sample, fall back to a builtin one.
+				if (texture != null || !Material.Shader.Textured) return Material;
+			}
+			var alpha = Alpha;
+			if (alpha == SpriteAlpha.Auto)
+			{
+				alpha = Color.W >= 1.0f && texture == null ? SpriteAlpha.Opaque : SpriteAlpha.Blend;
+			}
+			return alpha switch
+			{
+				SpriteAlpha.Opaque when texture == null => Renderer.OpaqueColoredMaterial,
+				SpriteAlpha.Opaque or SpriteAlpha.Cutout when texture != null => Renderer.CutoutMaterial,
+				_ => null,
+			};
+		}
+
 		public override void OnCreate()
 		{
 		}
 
-		public override void OnRender()
+		public override void OnExtract(RenderList list)
 		{
-			if (Sprite.Get() != null)
+			var texture = Sprite.Get();
+			var material = _PickMaterial(texture);
+			if (texture != null)
 			{
-				Renderer.RenderTexturedQuad(
-					Sprite.Get()!,
-					new(),
-					Color,
-					Camera.Active.ComputeTransformMatrix(Transform!.GlobalTransform)
-				);
+				list.AddTexturedQuad(Layer, texture, new(), Color, Transform!.RenderTransform, material);
 			}
 			else
 			{
-				Renderer.RenderColoredQuad(
-					Color, Camera.Active.ComputeTransformMatrix(Transform!.GlobalTransform)
-				);
+				list.AddColoredQuad(Layer, Color, Transform!.RenderTransform, material);
 			}
 		}
 	}
@@ -12,5 +12,23 @@ namespace RainEngine
 		{
 			ActiveWindow = new(RainNative.Interop.Engine_GetWindow());
 		}
+
+		private static bool _AllowIdle;
+
+		/// When set, the main loop stops polling and waits for input
+		/// (or a Wake) between frames, after a few settling frames.
+		public static bool AllowIdle
+		{
+			get => _AllowIdle;
+			set
+			{
+				if (_AllowIdle == value) return;
+				_AllowIdle = value;
+				RainNative.Interop.Engine_SetAllowIdle(value);
+			}
+		}
+
+		/// Run the next frames even if there was no input. Any thread.
+		public static void Wake() => RainNative.Interop.Engine_Wake();
 	}
 }
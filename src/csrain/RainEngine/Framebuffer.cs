@@ -1,16 +1,29 @@
+using System;
+
 namespace RainEngine
 {
-	public class Framebuffer
+	public class Framebuffer : IDisposable
 	{
-		public Texture ColorTexture { get; }
-		public Texture DepthTexture { get; }
+		public Texture ColorTexture { get; private set; }
+		public Texture DepthTexture { get; private set; }
 		public Extent2 Size { get; }
 
+		/// The attachments come from RenderTargetPool and go back to it on
+		/// Dispose, so a framebuffer of a size seen before is cheap.
 		public Framebuffer(Extent2 size)
 		{
 			Size = size;
-			ColorTexture = Texture.Create(size, RainNative.SgPixelFormat.DEFAULT, true);
-			DepthTexture = Texture.Create(size, RainNative.SgPixelFormat.DEPTH_STENCIL, true);
+			ColorTexture = RenderTargetPool.Rent(size, RainNative.SgPixelFormat.DEFAULT);
+			DepthTexture = RenderTargetPool.Rent(size, RainNative.SgPixelFormat.DEPTH_STENCIL);
+		}
+
+		/// Passes using this framebuffer must be disposed first.
+		public void Dispose()
+		{
+			if (ColorTexture == null) return;
+			RenderTargetPool.Return(ColorTexture);
+			RenderTargetPool.Return(DepthTexture);
+			ColorTexture = DepthTexture = null!;
 		}
 	}
 }
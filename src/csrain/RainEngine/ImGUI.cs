@@ -10,7 +10,7 @@ namespace RainEngine {
 			unsafe
 			{
 				RainNative.Interop.ImGUI_Data data;
-				RainNative.Interop.ImGUI_Init(1 << 16, &data);
+				RainNative.Interop.ImGUI_Init(&data);
 				ImGui.SetCurrentContext(data.Context);
 				ImGui.SetAllocatorFunctions(data.AllocFunc, data.FreeFunc);
 				ImGui.GetIO().ConfigFlags |= ImGuiConfigFlags.NavEnableKeyboard;
@@ -24,6 +24,54 @@ namespace RainEngine {
 		public static void EndRender() => RainNative.Interop.ImGUI_EndRender();
 	}
 
+	/// Renderer.LastFrame and its history in the top right corner.
+	/// Call between RainImGui.BeginRender and EndRender.
+	public static class RendererStatsOverlay
+	{
+		public static bool Visible = false;
+
+		private static string _Bytes(ulong bytes) =>
+			bytes >= 1 << 20 ? $"{bytes / (float)(1 << 20):F1} MiB"
+			: bytes >= 1 << 10 ? $"{bytes / (float)(1 << 10):F1} KiB"
+			: $"{bytes} B";
+
+		public static void Render()
+		{
+			if (!Visible) return;
+			const float pad = 10.0f;
+			var display = ImGui.GetIO().DisplaySize;
+			ImGui.SetNextWindowPos(new(display.X - pad, pad), ImGuiCond.Always, new(1.0f, 0.0f));
+			ImGui.SetNextWindowBgAlpha(0.35f);
+			var flags = ImGuiWindowFlags.NoDecoration | ImGuiWindowFlags.AlwaysAutoResize
+				| ImGuiWindowFlags.NoSavedSettings | ImGuiWindowFlags.NoFocusOnAppearing
+				| ImGuiWindowFlags.NoNav | ImGuiWindowFlags.NoMove;
+			if (ImGui.Begin("Renderer Stats", ref Visible, flags))
+			{
+				var stats = Renderer.LastFrame;
+				ImGui.Text($"Draws: {stats.Draws} ({stats.Instances} instances)");
+				ImGui.Text($"Pipelines: {stats.PipelineChanges}, bindings: {stats.BindingChanges}");
+				ImGui.Text($"Uniforms: {stats.UniformApplies} ({_Bytes(stats.UniformBytes)}), materials: {stats.MaterialUploads}");
+				ImGui.Text($"Uploaded: {_Bytes(stats.BufferBytes)} buffers, {_Bytes(stats.ImageBytes)} images");
+				ImGui.Text($"Texture updates: {stats.TextureUpdates} ({_Bytes(stats.TextureUpdateBytes)}),"
+					+ $" deferred: {stats.TextureUpdatesDeferred}");
+				ImGui.Text($"Upload ring: {_Bytes(stats.UploadRingBytes)}, waits: {stats.UploadRingWaits}");
+				ImGui.Text($"Texture memory: {_Bytes(stats.TextureMemory)}");
+
+				var size = new Vector2(240, 32);
+				ImGui.PlotLines("##Draws", ref Renderer.DrawHistory[0],
+					Renderer.HistoryLength, Renderer.HistoryOffset, "draws",
+					0, float.MaxValue, size);
+				ImGui.PlotLines("##StateChanges", ref Renderer.StateChangeHistory[0],
+					Renderer.HistoryLength, Renderer.HistoryOffset, "state changes",
+					0, float.MaxValue, size);
+				ImGui.PlotLines("##Uploads", ref Renderer.UploadBytesHistory[0],
+					Renderer.HistoryLength, Renderer.HistoryOffset, "bytes uploaded",
+					0, float.MaxValue, size);
+			}
+			ImGui.End();
+		}
+	}
+
 	public static class ImGuiUtil
 	{
 		// NB: Defaults from ImGui v1.89.7-docking
@@ -12,9 +12,21 @@ namespace RainEngine
 		// 	this._WindowHandle = windowHandle;
 		// }
 
+		/// GLFW_KEY_LAST + 1.
+		private const int _KeyCount = 349;
+		private static readonly bool[] _KeysDown = new bool[_KeyCount];
+
+		/// As of the start of the current update, so [ParallelUpdate]
+		/// components can read it from job threads.
 		public static bool GetKey(int keycode) =>
-			KeyboardCaptured ? false :
-			RainNative.Interop.Window_IsKeyDown(Window.Active._Handle, keycode);
+			!KeyboardCaptured && keycode >= 0 && keycode < _KeyCount && _KeysDown[keycode];
+
+		/// Main thread only, before anything is updated.
+		internal static unsafe void _Snapshot()
+		{
+			fixed (bool* down = _KeysDown)
+				RainNative.Interop.Window_GetKeys(Window.Active._Handle, down, _KeyCount);
+		}
 
 		// public static Input Active => Window.Active.Input;
 	}
@@ -0,0 +1,73 @@
+using System;
+using System.Collections.Generic;
+using System.Runtime.ExceptionServices;
+using System.Runtime.InteropServices;
+
+namespace RainEngine
+{
+	/// Front end of the native work-stealing job system (`rain_jobs_*`).
+	/// Bodies run on worker threads and on the calling thread, which
+	/// helps out until everything is done.
+	public static class Jobs
+	{
+		/// Threads besides the main thread that run jobs.
+		public static int WorkerCount { get; } = RainNative.Interop.Jobs_GetWorkerCount();
+
+		[UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+		private delegate void _JobFn(IntPtr data, UIntPtr begin, UIntPtr end);
+
+		// kept alive here, native code only has the function pointer.
+		private static readonly _JobFn _Trampoline = _Run;
+		private static readonly IntPtr _TrampolinePtr = Marshal.GetFunctionPointerForDelegate(_Trampoline);
+
+		private sealed class _ParallelFor
+		{
+			public Action<int, int> Body = null!;
+			public Exception? Error;
+		}
+
+		private static void _Run(IntPtr data, UIntPtr begin, UIntPtr end)
+		{
+			var state = (_ParallelFor)GCHandle.FromIntPtr(data).Target!;
+			// exceptions can't unwind through native frames.
+			if (state.Error != null) return;
+			try
+			{
+				state.Body((int)begin, (int)end);
+			}
+			catch (Exception e)
+			{
+				state.Error ??= e;
+			}
+		}
+
+		/// Calls `body(begin, end)` for batches covering [0, count) in
+		/// parallel and returns once all of them are done. `batch` is the
+		/// number of items per job, 0 lets the job system pick.
+		/// The first exception thrown by a batch is rethrown here.
+		public static void ParallelFor(int count, int batch, Action<int, int> body)
+		{
+			if (count <= 0) return;
+			var state = new _ParallelFor { Body = body };
+			var handle = GCHandle.Alloc(state);
+			try
+			{
+				RainNative.Interop.Jobs_ParallelFor(
+					_TrampolinePtr, GCHandle.ToIntPtr(handle), (ulong)count, (ulong)batch);
+			}
+			finally
+			{
+				handle.Free();
+			}
+			if (state.Error != null) ExceptionDispatchInfo.Capture(state.Error).Throw();
+		}
+
+		/// Calls `body` for every item of `items` in parallel.
+		/// `items` must not change until this returns.
+		public static void ParallelFor<T>(IReadOnlyList<T> items, Action<T> body, int batch = 0) =>
+			ParallelFor(items.Count, batch, (begin, end) =>
+			{
+				for (int i = begin; i < end; ++i) body(items[i]);
+			});
+	}
+}
@@ -7,7 +7,10 @@ namespace RainEngine
 	{
 		void Entry();
 		void Update(float deltaTime);
+		void FixedUpdate(float fixedDeltaTime);
+		void LateUpdate(float deltaTime);
 		void Render();
+		void Resize(int width, int height);
 		void Destroy();
 	}
 
@@ -32,6 +35,10 @@ namespace RainEngine
 
 		static void Update(float deltaTime)
 		{
+			Profiler.Update();
+			Renderer._UpdateStats();
+			Input._Snapshot();
+			Time.DeltaTime = deltaTime;
 			try
 			{
 				_App!.Update(deltaTime);
@@ -43,11 +50,54 @@ namespace RainEngine
 			}
 		}
 
-		static void Render()
+		static void FixedUpdate(float fixedDeltaTime)
 		{
+			Time.FixedDeltaTime = fixedDeltaTime;
+			Input._Snapshot();
+			try
+			{
+				_App!.FixedUpdate(fixedDeltaTime);
+			}
+			catch (Exception e)
+			{
+				Debug.Log($"EXCEPTION: {e}");
+				throw e;
+			}
+		}
+
+		static void LateUpdate(float deltaTime)
+		{
+			try
+			{
+				_App!.LateUpdate(deltaTime);
+			}
+			catch (Exception e)
+			{
+				Debug.Log($"EXCEPTION: {e}");
+				throw e;
+			}
+		}
+
+		static void Render(float alpha)
+		{
+			Time.InterpolationAlpha = alpha;
 			try
 			{
 				_App!.Render();
+				RenderTargetPool._EndFrame();
+			}
+			catch (Exception e)
+			{
+				Debug.Log($"EXCEPTION: {e}");
+				throw e;
+			}
+		}
+
+		static void Resize(int width, int height)
+		{
+			try
+			{
+				_App!.Resize(width, height);
 			}
 			catch (Exception e)
 			{
@@ -67,6 +117,7 @@ namespace RainEngine
 				Debug.Log($"EXCEPTION: {e}");
 				throw e;
 			}
+			RenderTargetPool.Clear();
 			RainImGui.DeInit();
 		}
 	}
@@ -0,0 +1,84 @@
+using System;
+using System.Numerics;
+
+namespace RainEngine
+{
+	/// Same values as `enum rain_blend_mode`.
+	public enum BlendMode : uint
+	{
+		Opaque = 0,
+		Alpha = 1,
+		Additive = 2,
+		Premultiplied = 3,
+	}
+
+	/// Fragment shader for quads (see rain/material.h for what is declared
+	/// in front of the body). Shaders live until the engine shuts down.
+	public sealed class Shader
+	{
+		internal IntPtr _Handle { get; }
+		public int ParamCount { get; }
+		public bool Textured { get; }
+
+		public Shader(string label, string fragmentBody, int paramCount = 0, bool textured = false)
+		{
+			ParamCount = paramCount;
+			Textured = textured;
+			_Handle = RainNative.Interop.Shader_Create(label, fragmentBody, paramCount, textured);
+		}
+	}
+
+	/// A shader with its blend and depth state and parameter values.
+	/// Materials with the same shader and state share one pipeline.
+	public sealed class Material : IDisposable
+	{
+		internal IntPtr _Handle { get; private set; }
+		public Shader Shader { get; }
+		public BlendMode Blend { get; }
+		public bool DepthTest { get; }
+		public bool DepthWrite { get; }
+
+		/// Unique per material, for sort keys.
+		public uint SortId { get; }
+
+		public Material(Shader shader, BlendMode blend = BlendMode.Alpha, bool depthTest = false, bool depthWrite = false)
+		{
+			(Shader, Blend, DepthTest, DepthWrite) = (shader, blend, depthTest, depthWrite);
+			_Handle = RainNative.Interop.Material_Create(shader._Handle, (uint)blend, depthTest, depthWrite);
+			SortId = RainNative.Interop.Material_GetId(_Handle);
+		}
+
+		/// Uploaded once before the next draw with this material,
+		/// not once per draw.
+		public unsafe void SetParams(int first, ReadOnlySpan<Vector4> values)
+		{
+			if (first < 0 || first + values.Length > Shader.ParamCount)
+				throw new ArgumentOutOfRangeException(nameof(first));
+			fixed (Vector4 *ptr = values)
+			{
+				RainNative.Interop.Material_SetParams(_Handle, first, ptr, values.Length);
+			}
+		}
+
+		public unsafe void SetParam(int index, Vector4 value) =>
+			SetParams(index, new ReadOnlySpan<Vector4>(&value, 1));
+
+		public void Dispose()
+		{
+			_Release();
+			GC.SuppressFinalize(this);
+		}
+
+		~Material()
+		{
+			_Release();
+		}
+
+		private void _Release()
+		{
+			if (_Handle == IntPtr.Zero) return;
+			RainNative.Interop.Material_DestroyAndFree(_Handle);
+			_Handle = IntPtr.Zero;
+		}
+	}
+}
@@ -30,6 +30,28 @@ namespace RainNative
 			ref Matrix4x4 trans
 		);
 
+		/// Same layout as `struct Renderer_Quad` in interop.c.
+		public struct Renderer_Quad
+		{
+			public Matrix4x4 Transform;
+			public Vector4 Color;
+			public IntPtr Texture;
+			/// Zero picks the builtin colored or textured material.
+			public IntPtr Material;
+			public UInt32 Sampler;
+			private UInt32 _Pad0, _Pad1, _Pad2;
+			public Renderer_Rect Rect;
+		}
+
+		[MethodImpl(MethodImplOptions.InternalCall)]
+		extern public static void Renderer_GetStats(out Renderer.FrameStats stats);
+
+		[MethodImpl(MethodImplOptions.InternalCall)]
+		extern public static void Renderer_SetDebugView(int view);
+
+		[MethodImpl(MethodImplOptions.InternalCall)]
+		extern public static void Renderer_RenderQuads(Renderer_Quad *quads, int count);
+
 		internal enum BuiltinSamplerId {
 			Nearest = 0,
 			Bilinear = 1,
@@ -62,6 +84,12 @@ namespace RainNative
 		[MethodImpl(MethodImplOptions.InternalCall)]
 		extern public static IntPtr Engine_GetWindow();
 
+		[MethodImpl(MethodImplOptions.InternalCall)]
+		extern public static void Engine_SetAllowIdle(bool allow);
+
+		[MethodImpl(MethodImplOptions.InternalCall)]
+		extern public static void Engine_Wake();
+
 		[MethodImpl(MethodImplOptions.InternalCall)]
 		extern public static void Window_SetTitle(IntPtr o, string v);
 		[MethodImpl(MethodImplOptions.InternalCall)]
@@ -74,6 +102,8 @@ namespace RainNative
 
 		[MethodImpl(MethodImplOptions.InternalCall)]
 		extern public static bool Window_IsKeyDown(IntPtr o, int keycode);
+		[MethodImpl(MethodImplOptions.InternalCall)]
+		extern public static void Window_GetKeys(IntPtr o, bool* outDown, int count);
 
 		[MethodImpl(MethodImplOptions.InternalCall)]
 		extern public static IntPtr Texture_Alloc();
@@ -81,6 +111,21 @@ namespace RainNative
 		[MethodImpl(MethodImplOptions.InternalCall)]
 		extern public static void Texture_DestroyAndFree(IntPtr o);
 
+		[MethodImpl(MethodImplOptions.InternalCall)]
+		extern public static IntPtr Shader_Create(string label, string fsBody, int paramCount, bool textured);
+
+		[MethodImpl(MethodImplOptions.InternalCall)]
+		extern public static IntPtr Material_Create(IntPtr shader, uint blend, bool depthTest, bool depthWrite);
+
+		[MethodImpl(MethodImplOptions.InternalCall)]
+		extern public static uint Material_GetId(IntPtr o);
+
+		[MethodImpl(MethodImplOptions.InternalCall)]
+		extern public static void Material_SetParams(IntPtr o, int first, Vector4 *values, int count);
+
+		[MethodImpl(MethodImplOptions.InternalCall)]
+		extern public static void Material_DestroyAndFree(IntPtr o);
+
 		[MethodImpl(MethodImplOptions.InternalCall)]
 		extern public static void Texture_FromFile(
 			IntPtr o,
@@ -106,7 +151,55 @@ namespace RainNative
 		[MethodImpl(MethodImplOptions.InternalCall)]
 		extern public static int Texture_GetFormat(IntPtr o);
 
-		
+		[MethodImpl(MethodImplOptions.InternalCall)]
+		extern public static bool Texture_Update(IntPtr o, ref Renderer_Rect rect, byte *pixels, int size);
+
+		[MethodImpl(MethodImplOptions.InternalCall)]
+		extern public static uint* Assets_GetGenerations();
+
+		[MethodImpl(MethodImplOptions.InternalCall)]
+		extern public static void Assets_Insert(IntPtr data, out AssetHandle handle);
+
+		[MethodImpl(MethodImplOptions.InternalCall)]
+		extern public static void Assets_Remove(ref AssetHandle handle);
+
+		[MethodImpl(MethodImplOptions.InternalCall)]
+		extern public static bool Assets_Replace(ref AssetHandle handle, IntPtr data);
+
+		[MethodImpl(MethodImplOptions.InternalCall)]
+		extern public static IntPtr Thumbnails_GetAtlas();
+
+		[MethodImpl(MethodImplOptions.InternalCall)]
+		extern public static uint* Thumbnails_GetReadyTickets();
+
+		[MethodImpl(MethodImplOptions.InternalCall)]
+		extern public static void Thumbnails_Request(int slot, uint ticket, string path);
+
+		[MethodImpl(MethodImplOptions.InternalCall)]
+		extern public static int Jobs_GetWorkerCount();
+
+		[MethodImpl(MethodImplOptions.InternalCall)]
+		extern public static void Jobs_ParallelFor(IntPtr fn, IntPtr data, ulong count, ulong batch);
+
+		[MethodImpl(MethodImplOptions.InternalCall)]
+		extern public static int Profiler_GetMode();
+
+		[MethodImpl(MethodImplOptions.InternalCall)]
+		extern public static void Profiler_GetFrameStats(out Profiler.FrameStats stats);
+
+		/// NB: DO NOT CHANGE THIS STRUCT! (see struct rain_profiler_type_stats)
+		public struct Profiler_TypeStats
+		{
+			public IntPtr Namespace, Name;
+			public ulong Samples, Bytes;
+		}
+
+		[MethodImpl(MethodImplOptions.InternalCall)]
+		extern public static int Profiler_GetTypeStats(Profiler_TypeStats *types, int max);
+
+		[MethodImpl(MethodImplOptions.InternalCall)]
+		extern public static void Profiler_ResetTypeStats();
+
 		public struct ImGUI_Data
 		{
 			public IntPtr Context;
@@ -114,7 +207,7 @@ namespace RainNative
 		}
 
 		[MethodImpl(MethodImplOptions.InternalCall)]
-		extern public static void ImGUI_Init(ulong maxVertices, ImGUI_Data *p);
+		extern public static void ImGUI_Init(ImGUI_Data *p);
 		
 		[MethodImpl(MethodImplOptions.InternalCall)]
 		extern public static void ImGUI_DeInit();
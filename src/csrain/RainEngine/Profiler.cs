@@ -0,0 +1,108 @@
+using System;
+using System.Collections.Generic;
+using System.Runtime.InteropServices;
+
+namespace RainEngine
+{
+	public enum ProfilerMode
+	{
+		Off = 0,
+		Count = 1,
+		Sampled = 2
+	}
+
+	/// Managed allocation and GC pause stats from the native mono profiler.
+	/// The mode is picked with the RAIN_PROFILER environment variable, allocations
+	/// are only tracked when it is count or sampled.
+	public static class Profiler
+	{
+		/// NB: DO NOT CHANGE THIS STRUCT! (see struct rain_profiler_frame_stats)
+		public struct FrameStats
+		{
+			public ulong AllocCount;
+			public ulong AllocBytes;
+			public uint GCCount;
+			public uint GCMajorCount;
+			public double GCPauseMs;
+			public double GCMaxPauseMs;
+		}
+
+		public struct TypeStats
+		{
+			public string Name;
+			public ulong EstimatedCount;
+			public ulong EstimatedBytes;
+		}
+
+		/// Same as RAIN_PROFILER_SAMPLE_INTERVAL.
+		public const int SampleInterval = 16;
+		public const int HistoryLength = 240;
+		private const int MaxTypes = 1024;
+
+		public static ProfilerMode Mode { get; } =
+			(ProfilerMode)RainNative.Interop.Profiler_GetMode();
+
+		public static FrameStats LastFrame { get; private set; }
+		public static double MaxGCPauseMs { get; private set; }
+
+		/// Ring buffers of the last HistoryLength frames, starting at HistoryOffset.
+		public static readonly float[] AllocCountHistory = new float[HistoryLength];
+		public static readonly float[] GCPauseHistory = new float[HistoryLength];
+		public static int HistoryOffset { get; private set; }
+
+		private static readonly RainNative.Interop.Profiler_TypeStats[] _NativeTypes = new RainNative.Interop.Profiler_TypeStats[MaxTypes];
+		private static readonly TypeStats[] _Types = new TypeStats[MaxTypes];
+		private static readonly Dictionary<IntPtr, string> _TypeNames = new();
+
+		internal static void Update()
+		{
+			RainNative.Interop.Profiler_GetFrameStats(out var stats);
+			LastFrame = stats;
+			if (stats.GCMaxPauseMs > MaxGCPauseMs) MaxGCPauseMs = stats.GCMaxPauseMs;
+
+			AllocCountHistory[HistoryOffset] = stats.AllocCount;
+			GCPauseHistory[HistoryOffset] = (float)stats.GCPauseMs;
+			HistoryOffset = (HistoryOffset + 1) % HistoryLength;
+		}
+
+		private class _ByBytes : IComparer<TypeStats>
+		{
+			public int Compare(TypeStats a, TypeStats b) => b.EstimatedBytes.CompareTo(a.EstimatedBytes);
+		}
+		private static readonly _ByBytes _ByBytesComparer = new();
+
+		/// Allocating types since the last reset, most bytes first.
+		/// Empty unless Mode is Sampled. The segment is reused by the next call.
+		public static ArraySegment<TypeStats> GetSampledTypes()
+		{
+			int count;
+			unsafe
+			{
+				fixed (RainNative.Interop.Profiler_TypeStats* p = _NativeTypes)
+					count = RainNative.Interop.Profiler_GetTypeStats(p, MaxTypes);
+			}
+
+			for (int i = 0; i < count; ++i)
+			{
+				var native = _NativeTypes[i];
+				if (!_TypeNames.TryGetValue(native.Name, out var name))
+				{
+					var ns = Marshal.PtrToStringAnsi(native.Namespace);
+					name = Marshal.PtrToStringAnsi(native.Name)!;
+					if (!string.IsNullOrEmpty(ns)) name = $"{ns}.{name}";
+					_TypeNames[native.Name] = name;
+				}
+				_Types[i] = new()
+				{
+					Name = name,
+					EstimatedCount = native.Samples * SampleInterval,
+					EstimatedBytes = native.Bytes * SampleInterval
+				};
+			}
+			Array.Sort(_Types, 0, count, _ByBytesComparer);
+			return new(_Types, 0, count);
+		}
+
+		public static void ResetSampledTypes() => RainNative.Interop.Profiler_ResetTypeStats();
+	}
+}
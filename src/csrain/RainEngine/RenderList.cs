@@ -0,0 +1,213 @@
+using System;
+using System.Collections.Generic;
+using System.Numerics;
+
+namespace RainEngine
+{
+	/// Packs what decides the order of a draw into 64 bits, most
+	/// significant first:
+	///   translucent (1) | depth (32) | material (16) | texture (15)
+	/// The depth written is derived from the layer first, see LayerDepth,
+	/// so higher layers are nearer and cover lower ones whatever their
+	/// blending. Opaque draws come first, front to back with depth test
+	/// and write, so whatever they cover isn't shaded. Translucent draws
+	/// follow back to front, tested against the opaque ones. Draws at the
+	/// same depth are grouped by material and texture.
+	public static class SortKey
+	{
+		/// Layers are clamped to this range.
+		public const int MinLayer = sbyte.MinValue, MaxLayer = sbyte.MaxValue;
+
+		private const int _LayerCount = MaxLayer - MinLayer + 1;
+		/// Keeps depth 1 inside its layer's band of the depth buffer.
+		private const double _WithinLayer = 1.0 - 1.0 / (1 << 16);
+
+		/// What is written to the depth buffer, in [0, 1). Every layer
+		/// gets a band of its own, `depth` (in [0, 1], 0 being the
+		/// nearest) orders draws within it.
+		public static double LayerDepth(int layer, float depth)
+		{
+			int band = MaxLayer - Math.Min(Math.Max(layer, MinLayer), MaxLayer);
+			return (band + Math.Min(Math.Max(depth, 0.0f), 1.0f) * _WithinLayer) / _LayerCount;
+		}
+
+		/// `layerDepth` from LayerDepth.
+		public static ulong Pack(bool translucent, double layerDepth, uint material, uint texture)
+		{
+			ulong depthBits = (ulong)(layerDepth * uint.MaxValue);
+			if (translucent) depthBits = uint.MaxValue - depthBits;
+			return (translucent ? 1UL : 0UL) << 63
+				| depthBits << 31
+				| (ulong)(material & 0xFFFF) << 15
+				| (texture & 0x7FFF);
+		}
+	}
+
+	/// Quads recorded by Component.OnExtract, one list per job batch.
+	/// The scene concatenates the batches in order and radix sorts the
+	/// result by SortKey. The sort is stable, so equal keys keep the
+	/// order of the entities.
+	public sealed class RenderList
+	{
+		private RainNative.Interop.Renderer_Quad[] _Quads = new RainNative.Interop.Renderer_Quad[64];
+		private ulong[] _Keys = new ulong[64];
+
+		public int Count { get; private set; }
+
+		/// Projection * view of the camera the scene renders with.
+		public Matrix4x4 ViewProjection { get; internal set; }
+
+		internal uint _Sampler;
+
+		public void Clear() => Count = 0;
+
+		private ref RainNative.Interop.Renderer_Quad _Add(
+			int layer,
+			Matrix4x4 model,
+			Vector4 color,
+			Material? material,
+			uint builtinMaterial,
+			uint texture
+		)
+		{
+			if (Count == _Quads.Length)
+			{
+				Array.Resize(ref _Quads, Count * 2);
+				Array.Resize(ref _Keys, Count * 2);
+			}
+			ref var quad = ref _Quads[Count];
+			// same as Camera.ComputeTransformMatrix.
+			var transform = ViewProjection * Matrix4x4.Transpose(model);
+			quad.Color = color;
+			quad.Material = material?._Handle ?? IntPtr.Zero;
+
+			// the quad's center in clip space is the last column.
+			float w = transform.M44;
+			float depth = (w != 0.0f ? transform.M34 / w : transform.M34) * 0.5f + 0.5f;
+			double layerDepth = SortKey.LayerDepth(layer, depth);
+			// z = ndc * w for the whole quad, the third row yields z.
+			float ndc = (float)(layerDepth * 2.0 - 1.0);
+			transform.M31 = ndc * transform.M41;
+			transform.M32 = ndc * transform.M42;
+			transform.M33 = ndc * transform.M43;
+			transform.M34 = ndc * transform.M44;
+			quad.Transform = transform;
+
+			bool translucent = (material?.Blend ?? BlendMode.Alpha) != BlendMode.Opaque;
+			// builtin materials are told apart from the others by the top bit.
+			uint materialId = material?.SortId ?? (0x8000 | builtinMaterial);
+			_Keys[Count++] = SortKey.Pack(translucent, layerDepth, materialId, texture);
+			return ref quad;
+		}
+
+		/// `material` null uses the builtin colored quad.
+		public void AddColoredQuad(int layer, Vector4 color, Matrix4x4 model, Material? material = null)
+		{
+			ref var quad = ref _Add(layer, model, color, material, 0, 0);
+			quad.Texture = IntPtr.Zero;
+		}
+
+		/// `material` null uses the builtin textured quad.
+		public void AddTexturedQuad(int layer, Texture texture, Rect2 rect, Vector4 tint, Matrix4x4 model, Material? material = null)
+		{
+			ref var quad = ref _Add(layer, model, tint, material, 1, texture._SortId);
+			quad.Texture = texture._Handle;
+			quad.Sampler = _Sampler;
+			quad.Rect = new() { OffsetX = rect.X, OffsetY = rect.Y, Width = rect.Width, Height = rect.Height };
+		}
+
+		internal void _Append(RenderList other)
+		{
+			int count = Count + other.Count;
+			if (count > _Quads.Length)
+			{
+				int capacity = Math.Max(count, _Quads.Length * 2);
+				Array.Resize(ref _Quads, capacity);
+				Array.Resize(ref _Keys, capacity);
+			}
+			Array.Copy(other._Quads, 0, _Quads, Count, other.Count);
+			Array.Copy(other._Keys, 0, _Keys, Count, other.Count);
+			Count = count;
+		}
+
+		private int[] _Order = new int[0], _OrderScratch = new int[0];
+		private ulong[] _KeyScratch = new ulong[0];
+		private RainNative.Interop.Renderer_Quad[] _Sorted = new RainNative.Interop.Renderer_Quad[0];
+		private readonly int[] _Histograms = new int[8 * 256];
+
+		/// LSD radix sort by key, a byte per pass. Passes where every key
+		/// has the same byte are skipped, which for the usual scene leaves
+		/// only a few. Nothing happens if the keys already are in order.
+		internal void _Sort()
+		{
+			bool sorted = true;
+			for (int i = 1; i < Count && sorted; ++i) sorted = _Keys[i - 1] <= _Keys[i];
+			if (sorted) return;
+
+			if (_Order.Length < Count)
+			{
+				_Order = new int[_Quads.Length];
+				_OrderScratch = new int[_Quads.Length];
+				_KeyScratch = new ulong[_Quads.Length];
+			}
+
+			// all eight histograms in one go.
+			Array.Clear(_Histograms, 0, _Histograms.Length);
+			for (int i = 0; i < Count; ++i)
+			{
+				ulong key = _Keys[i];
+				for (int pass = 0; pass < 8; ++pass)
+				{
+					++_Histograms[pass * 256 + (int)((key >> (pass * 8)) & 0xFF)];
+				}
+				_Order[i] = i;
+			}
+
+			ulong[] keys = _Keys, keysOut = _KeyScratch;
+			int[] order = _Order, orderOut = _OrderScratch;
+			for (int pass = 0; pass < 8; ++pass)
+			{
+				int offset = pass * 256;
+				int shift = pass * 8;
+				if (_Histograms[offset + (int)((keys[0] >> shift) & 0xFF)] == Count) continue;
+
+				// counts to starting positions.
+				int sum = 0;
+				for (int digit = 0; digit < 256; ++digit)
+				{
+					int count = _Histograms[offset + digit];
+					_Histograms[offset + digit] = sum;
+					sum += count;
+				}
+				for (int i = 0; i < Count; ++i)
+				{
+					int at = _Histograms[offset + (int)((keys[i] >> shift) & 0xFF)]++;
+					keysOut[at] = keys[i];
+					orderOut[at] = order[i];
+				}
+				(keys, keysOut) = (keysOut, keys);
+				(order, orderOut) = (orderOut, order);
+			}
+
+			if (_Sorted.Length != _Quads.Length)
+			{
+				_Sorted = new RainNative.Interop.Renderer_Quad[_Quads.Length];
+			}
+			for (int i = 0; i < Count; ++i) _Sorted[i] = _Quads[order[i]];
+			(_Quads, _Sorted) = (_Sorted, _Quads);
+			if (!ReferenceEquals(keys, _Keys))
+			{
+				// ended up in the scratch array, keep the arrays' roles.
+				Array.Copy(keys, _Keys, Count);
+			}
+		}
+
+		internal unsafe void _Submit()
+		{
+			fixed (RainNative.Interop.Renderer_Quad *quads = _Quads)
+			{
+				RainNative.Interop.Renderer_RenderQuads(quads, Count);
+			}
+		}
+	}
+}
@@ -3,9 +3,9 @@ using System.Numerics;
 
 namespace RainEngine
 {
-	public class RenderPass
+	public class RenderPass : IDisposable
 	{
-		internal IntPtr _Handle { get; }
+		internal IntPtr _Handle { get; private set; }
 		public Framebuffer Framebuffer { get; }
 
 		public RenderPass(Framebuffer framebuffer)
@@ -17,9 +17,23 @@ namespace RainEngine
 			);
 		}
 
+		/// Doesn't touch the framebuffer, which has to outlive the pass.
+		public void Dispose()
+		{
+			_Release();
+			GC.SuppressFinalize(this);
+		}
+
 		~RenderPass()
 		{
+			_Release();
+		}
+
+		private void _Release()
+		{
+			if (_Handle == IntPtr.Zero) return;
 			RainNative.Interop.RenderPass_DestroyAndFree(_Handle);
+			_Handle = IntPtr.Zero;
 		}
 	}
 }
@@ -0,0 +1,81 @@
+using System;
+using System.Collections.Generic;
+
+namespace RainEngine
+{
+	/// Render target textures keyed by size and format. Returned targets
+	/// are handed out again instead of creating new GL images, and
+	/// destroyed once nobody asked for them for a while.
+	public static class RenderTargetPool
+	{
+		/// Frames a returned target is kept around without being rented.
+		public static int MaxIdleFrames { get; set; } = 120;
+
+		private struct _Free
+		{
+			public Texture Texture;
+			public long ReturnedFrame;
+		}
+
+		private static readonly Dictionary<(ulong, ulong, RainNative.SgPixelFormat), Stack<_Free>> _FreeTargets = new();
+		private static long _Frame;
+
+		private static (ulong, ulong, RainNative.SgPixelFormat) _Key(Extent2 size, RainNative.SgPixelFormat format) =>
+			(size.Width, size.Height, format);
+
+		public static Texture Rent(Extent2 size, RainNative.SgPixelFormat format)
+		{
+			if (_FreeTargets.TryGetValue(_Key(size, format), out var free) && free.Count > 0)
+			{
+				return free.Pop().Texture;
+			}
+			return Texture.Create(size, format, true);
+		}
+
+		/// `texture` must have come from Rent and must not be used after this.
+		public static void Return(Texture texture)
+		{
+			var key = _Key(texture.Size, texture._PixelFormat);
+			if (!_FreeTargets.TryGetValue(key, out var free))
+			{
+				free = new();
+				_FreeTargets[key] = free;
+			}
+			free.Push(new() { Texture = texture, ReturnedFrame = _Frame });
+		}
+
+		/// Called once per frame, destroys targets idle for too long.
+		internal static void _EndFrame()
+		{
+			++_Frame;
+			foreach (var free in _FreeTargets.Values)
+			{
+				// the oldest are at the bottom, rebuild only if there's something to drop.
+				if (free.Count == 0) continue;
+				bool stale = false;
+				foreach (var entry in free) stale |= _Frame - entry.ReturnedFrame > MaxIdleFrames;
+				if (!stale) continue;
+
+				var keep = new List<_Free>();
+				foreach (var entry in free)
+				{
+					if (_Frame - entry.ReturnedFrame > MaxIdleFrames) entry.Texture.Dispose();
+					else keep.Add(entry);
+				}
+				free.Clear();
+				// enumerated top to bottom, push back bottom first.
+				for (int i = keep.Count - 1; i >= 0; --i) free.Push(keep[i]);
+			}
+		}
+
+		/// Destroys every target that isn't rented.
+		public static void Clear()
+		{
+			foreach (var free in _FreeTargets.Values)
+			{
+				foreach (var entry in free) entry.Texture.Dispose();
+				free.Clear();
+			}
+		}
+	}
+}
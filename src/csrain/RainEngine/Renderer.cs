@@ -4,8 +4,61 @@ using System.Numerics;
 namespace RainEngine
 {
 
+	/// Same values as `enum rain_renderer_debug_view`.
+	public enum RendererDebugView
+	{
+		None = 0,
+		/// Additive heatmap of how often each pixel is drawn.
+		Overdraw = 1,
+		/// Quads tinted by batch, colors change where state changed.
+		Batches = 2,
+		/// Red: switched pipeline, yellow: switched texture, grey: neither.
+		StateChanges = 3,
+	}
+
 	public static class Renderer
 	{
+		private static RendererDebugView _DebugView;
+
+		/// Applies to every quad the renderer draws, in any pass.
+		public static RendererDebugView DebugView
+		{
+			get => _DebugView;
+			set
+			{
+				_DebugView = value;
+				RainNative.Interop.Renderer_SetDebugView((int)value);
+			}
+		}
+
+		/// Opaque counterparts of the builtin quads. They are drawn front to
+		/// back with depth test and write, before anything translucent.
+		public static Material OpaqueColoredMaterial { get; private set; } = null!;
+		/// Discards texels with alpha under the first param (0.5), and draws
+		/// the rest opaque.
+		public static Material CutoutMaterial { get; private set; } = null!;
+
+		/// Main thread, before anything extracts.
+		internal static void _InitBuiltinMaterials()
+		{
+			if (OpaqueColoredMaterial != null) return;
+			var opaqueColored = new Shader("Builtin Opaque Colored Quad Shader",
+				"void main() {\n" +
+				"  o_color = vec4(u_tint.rgb, 1.0);\n" +
+				"}\n");
+			OpaqueColoredMaterial = new(opaqueColored, BlendMode.Opaque, depthTest: true, depthWrite: true);
+
+			var cutout = new Shader("Builtin Cutout Quad Shader",
+				"void main() {\n" +
+				"  vec4 color = u_tint * texture(u_texture, s_uv);\n" +
+				"  if (color.a < u_params[0].x) discard;\n" +
+				"  o_color = vec4(color.rgb, 1.0);\n" +
+				"}\n",
+				paramCount: 1, textured: true);
+			CutoutMaterial = new(cutout, BlendMode.Opaque, depthTest: true, depthWrite: true);
+			CutoutMaterial.SetParam(0, new(0.5f, 0.0f, 0.0f, 0.0f));
+		}
+
 		public static void RenderColoredQuad(Vector4 color, Matrix4x4 transform) =>
 			RainNative.Interop.Renderer_RenderColoredQuad(ref color, ref transform);
 
@@ -52,6 +105,60 @@ namespace RainEngine
 			);
 		}
 
+		/// What the render thread did with the GPU in a frame, ImGui included.
+		/// NB: DO NOT CHANGE THIS STRUCT! (see struct rain_renderer_stats)
+		public struct FrameStats
+		{
+			public uint Draws;
+			public uint Instances;
+			public uint PipelineChanges;
+			public uint BindingChanges;
+			public uint UniformApplies;
+			public uint MaterialUploads;
+			public ulong UniformBytes;
+			public ulong BufferBytes;
+			public ulong ImageBytes;
+			/// Held by all textures and render targets, not per frame.
+			public ulong TextureMemory;
+			/// Texture.Update rects copied to their textures.
+			public uint TextureUpdates;
+			/// Still queued after this frame's, over the upload budget.
+			public uint TextureUpdatesDeferred;
+			/// Frames the upload ring had to wait for the GPU to finish reading.
+			public uint UploadRingWaits;
+			public ulong TextureUpdateBytes;
+			/// Vertices, indices and pixels written to the upload ring.
+			public ulong UploadRingBytes;
+		}
+
+		public const int HistoryLength = Profiler.HistoryLength;
+
+		/// The last frame the render thread finished, which lags the one
+		/// being recorded by a frame when it runs asynchronously.
+		public static FrameStats LastFrame { get; private set; }
+
+		/// Ring buffers of the last HistoryLength frames, starting at HistoryOffset.
+		public static readonly float[] DrawHistory = new float[HistoryLength];
+		public static readonly float[] StateChangeHistory = new float[HistoryLength];
+		public static readonly float[] UploadBytesHistory = new float[HistoryLength];
+		public static int HistoryOffset { get; private set; }
+
+		/// Pipeline and binding changes in the last finished frame, lower
+		/// means sorting is batching draws well.
+		public static int StateChanges => (int)(LastFrame.PipelineChanges + LastFrame.BindingChanges);
+
+		internal static void _UpdateStats()
+		{
+			RainNative.Interop.Renderer_GetStats(out var stats);
+			LastFrame = stats;
+
+			DrawHistory[HistoryOffset] = stats.Draws;
+			StateChangeHistory[HistoryOffset] = stats.PipelineChanges + stats.BindingChanges;
+			UploadBytesHistory[HistoryOffset] = stats.UniformBytes + stats.BufferBytes + stats.ImageBytes
+				+ stats.UploadRingBytes;
+			HistoryOffset = (HistoryOffset + 1) % HistoryLength;
+		}
+
 		// public static Renderer? Active => Engine.ActiveRenderer;
 	}
 
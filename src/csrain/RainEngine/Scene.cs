@@ -13,6 +13,7 @@ namespace RainEngine
 
 	public class Scene
 	{
+		/// Only ever appended to.
 		internal List<Entity> Entities;
 		private uint NextId = 0;
 
@@ -31,6 +32,8 @@ namespace RainEngine
 
 		public Entity CreateEntity(string name, params Component[] components)
 		{
+			if (_ParallelBuffer != null)
+				throw new InvalidOperationException("CreateEntity from a parallel update, use Scene.Defer");
 			Entity entity = new(NextId++, this, name);
 			Entities.Add(entity);
 			foreach (var component in components)
@@ -51,19 +54,188 @@ namespace RainEngine
 			}
 		}
 
+		/// Commands deferred by the parallel update batch running on this thread.
+		[ThreadStatic]
+		private static List<Action>? _ParallelBuffer;
+
+		/// One per batch, played back in batch order so the result doesn't
+		/// depend on which thread ran what.
+		private readonly List<List<Action>> _ParallelBuffers = new();
+		private readonly List<Entity> _ParallelEntities = new();
+
+		/// Runs `command` on the main thread once the parallel part of
+		/// OnUpdate is done, in entity order. Runs it right away anywhere else.
+		public void Defer(Action command)
+		{
+			if (_ParallelBuffer != null) _ParallelBuffer.Add(command);
+			else command();
+		}
+
+		/// Entities per job, small batches aren't worth scheduling.
+		private const int _ParallelBatchMin = 32;
+
+		/// [ParallelUpdate] components are updated first, spread over job
+		/// threads, then their deferred commands run, then every other
+		/// component is updated in order on the main thread.
 		public void OnUpdate(float deltaTime)
+		{
+			_ParallelEntities.Clear();
+			foreach (var entity in Entities)
+			{
+				// looks at every component, so the job threads only read the attribute cache.
+				bool parallel = false;
+				foreach (var component in entity.Components)
+				{
+					parallel |= component._ParallelUpdate;
+				}
+				if (parallel) _ParallelEntities.Add(entity);
+			}
+			if (_ParallelEntities.Count > 0)
+			{
+				_UpdateParallel(deltaTime);
+			}
+
+			foreach (var entity in Entities)
+			{
+				foreach (var component in entity.Components)
+				{
+					if (!component._ParallelUpdate) component.OnUpdate(deltaTime);
+				}
+			}
+		}
+
+		private int _BatchSize(int count) =>
+			Math.Max(_ParallelBatchMin, count / ((Jobs.WorkerCount + 1) * 4));
+
+		private void _Extract()
+		{
+			Renderer._InitBuiltinMaterials();
+			var camera = Camera.Active;
+			var viewProjection = camera.ProjMatrix * camera.ViewMatrix;
+			uint sampler = RainNative.Interop.Renderer_GetBuiltinSampler(
+				(uint)RainNative.Interop.BuiltinSamplerId.Nearest);
+
+			int count = _ExtractEntities.Count;
+			int batch = _BatchSize(count);
+			int batchCount = (count + batch - 1) / batch;
+			while (_ExtractLists.Count < batchCount) _ExtractLists.Add(new());
+			for (int i = 0; i < batchCount; ++i)
+			{
+				_ExtractLists[i].Clear();
+				_ExtractLists[i].ViewProjection = viewProjection;
+				_ExtractLists[i]._Sampler = sampler;
+			}
+
+			Jobs.ParallelFor(count, batch, (begin, end) =>
+			{
+				var list = _ExtractLists[begin / batch];
+				for (int i = begin; i < end; ++i)
+				{
+					foreach (var component in _ExtractEntities[i].Components)
+					{
+						if (component._Extracts) component.OnExtract(list);
+					}
+				}
+			});
+
+			// batches cover the entities in order, so this is deterministic.
+			_MergedList.Clear();
+			for (int i = 0; i < batchCount; ++i) _MergedList._Append(_ExtractLists[i]);
+			_MergedList._Sort();
+			_MergedList._Submit();
+		}
+
+		private void _UpdateParallel(float deltaTime)
+		{
+			int count = _ParallelEntities.Count;
+			int batch = _BatchSize(count);
+			int batchCount = (count + batch - 1) / batch;
+			while (_ParallelBuffers.Count < batchCount) _ParallelBuffers.Add(new());
+
+			try
+			{
+				Jobs.ParallelFor(count, batch, (begin, end) =>
+				{
+					_ParallelBuffer = _ParallelBuffers[begin / batch];
+					try
+					{
+						for (int i = begin; i < end; ++i)
+						{
+							foreach (var component in _ParallelEntities[i].Components)
+							{
+								if (component._ParallelUpdate) component.OnUpdate(deltaTime);
+							}
+						}
+					}
+					finally
+					{
+						_ParallelBuffer = null;
+					}
+				});
+
+				for (int i = 0; i < batchCount; ++i)
+				{
+					foreach (var command in _ParallelBuffers[i]) command();
+				}
+			}
+			finally
+			{
+				for (int i = 0; i < batchCount; ++i) _ParallelBuffers[i].Clear();
+			}
+		}
+
+		public void OnFixedUpdate(float fixedDeltaTime)
 		{
+			foreach (var entity in Entities)
+			{
+				entity.Transform?._BeginFixedStep();
+			}
 			foreach (var entity in Entities)
 			{
 				foreach (var component in entity.Components)
 				{
-					component.OnUpdate(deltaTime);
+					component.OnFixedUpdate(fixedDeltaTime);
 				}
 			}
 		}
 
+		public void OnLateUpdate(float deltaTime)
+		{
+			foreach (var entity in Entities)
+			{
+				foreach (var component in entity.Components)
+				{
+					component.OnLateUpdate(deltaTime);
+				}
+			}
+		}
+
+		private readonly List<RenderList> _ExtractLists = new();
+		private readonly List<Entity> _ExtractEntities = new();
+		private readonly RenderList _MergedList = new();
+
+		/// OnExtract of every component, spread over job threads, then the
+		/// merged and sorted quads are drawn. OnRender runs afterwards, in
+		/// order on the main thread.
 		public void OnRender()
 		{
+			_ExtractEntities.Clear();
+			foreach (var entity in Entities)
+			{
+				// lazily computed, do it here rather than racing on the job threads.
+				_ = entity.Transform?.LocalTransform;
+				bool extracts = false;
+				foreach (var component in entity.Components)
+				{
+					extracts |= component._Extracts;
+				}
+				if (extracts) _ExtractEntities.Add(entity);
+			}
+			if (_ExtractEntities.Count > 0)
+			{
+				_Extract();
+			}
+
 			foreach (var entity in Entities)
 			{
 				foreach (var component in entity.Components)
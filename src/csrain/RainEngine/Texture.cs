@@ -4,6 +4,9 @@ using System.Text.Json.Serialization;
 
 namespace RainEngine
 {
+	/// Same values as `enum rain_texture_format`, picked per texture in the
+	/// manifest. Grey ones are uploaded as R8/RG8 but sample as grey RGBA,
+	/// RGB is padded to RGBA.
 	public enum TextureFormat
 	{
 		Unknown = 0,
@@ -13,14 +16,24 @@ namespace RainEngine
 		RGBA = 4
 	}
 
-	public class Texture
+	public class Texture : IDisposable
 	{
 		[JsonIgnore] public Extent2 Size { get; }
 		[JsonIgnore] public TextureFormat Format { get; }
 
 		public AssetID AssetID { get; }
 
-		internal IntPtr _Handle { get; }
+		internal IntPtr _Handle { get; private set; }
+
+		/// What it was created with, for render targets.
+		internal RainNative.SgPixelFormat _PixelFormat { get; private set; }
+
+		/// Created with `dynamic`, can be changed with Update.
+		[JsonIgnore] public bool Dynamic { get; private set; }
+
+		private static uint _NextSortId;
+		/// Groups draws by texture in SortKey.
+		internal uint _SortId { get; } = ++_NextSortId;
 
 		[JsonConstructor]
 		internal Texture(AssetID assetID, IntPtr handle, Extent2 size, TextureFormat format)
@@ -37,9 +50,24 @@ namespace RainEngine
 			AssetID = assetID;
 		}
 
+		/// Releases the GPU image now instead of whenever the GC gets to it.
+		/// Either way it's destroyed after the frames that still use it.
+		public void Dispose()
+		{
+			_Release();
+			GC.SuppressFinalize(this);
+		}
+
 		~Texture()
 		{
+			_Release();
+		}
+
+		private void _Release()
+		{
+			if (_Handle == IntPtr.Zero) return;
 			RainNative.Interop.Texture_DestroyAndFree(_Handle);
+			_Handle = IntPtr.Zero;
 		}
 
 		public static Texture Create(
@@ -58,7 +86,10 @@ namespace RainEngine
 
 			IntPtr handle = RainNative.Interop.Texture_Alloc();
 			RainNative.Interop.Texture_Init(handle, ref desc);
-			return new(AssetID.Empty, handle, size, TextureFormat.Unknown); // TODO: make texture format correct.
+			return new(AssetID.Empty, handle, size, TextureFormat.Unknown) // TODO: make texture format correct.
+			{
+				_PixelFormat = pixelFormat
+			};
 		}
 
 		public static Texture FromFile(AssetID assetID, string path, TextureFormat format, bool dynamic = false)
@@ -76,7 +107,37 @@ namespace RainEngine
 
 			int actualFormat = RainNative.Interop.Texture_GetFormat(handle);
 
-			return new(assetID, handle, size, (TextureFormat)actualFormat);
+			return new(assetID, handle, size, (TextureFormat)actualFormat) { Dynamic = dynamic };
+		}
+
+		/// Replaces the texels in `rect` with `pixels`, tightly packed rows
+		/// of Format, in the order the file was loaded in (bottom row first).
+		/// The pixels are copied. The texture changes before the next frame
+		/// draws, or a later one if this frame's upload budget is used up.
+		public unsafe void Update(Rect2 rect, ReadOnlySpan<byte> pixels)
+		{
+			if (_Handle == IntPtr.Zero)
+				throw new ObjectDisposedException(nameof(Texture));
+			if (!Dynamic)
+				throw new InvalidOperationException("only dynamic textures can be updated");
+			if (rect.Width == 0 || rect.Height == 0
+					|| rect.X + rect.Width > Size.Width || rect.Y + rect.Height > Size.Height)
+				throw new ArgumentOutOfRangeException(nameof(rect));
+			if ((ulong)pixels.Length != rect.Width * rect.Height * (ulong)Format)
+				throw new ArgumentException($"expected {rect.Width * rect.Height * (ulong)Format} bytes", nameof(pixels));
+
+			var nativeRect = new RainNative.Interop.Renderer_Rect
+			{
+				OffsetX = rect.X, OffsetY = rect.Y, Width = rect.Width, Height = rect.Height
+			};
+			bool queued;
+			fixed (byte *ptr = pixels)
+			{
+				queued = RainNative.Interop.Texture_Update(_Handle, ref nativeRect, ptr, pixels.Length);
+			}
+			// the native side logged why.
+			if (!queued)
+				throw new InvalidOperationException("the texture update was rejected");
 		}
 	}
 }
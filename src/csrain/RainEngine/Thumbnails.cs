@@ -0,0 +1,88 @@
+using System;
+using System.Collections.Generic;
+using System.Numerics;
+using ImGuiNET;
+
+namespace RainEngine
+{
+	/// Downscaled texture asset previews, decoded off the main thread into one
+	/// fixed-size atlas (see rain/thumbnails.h). Slots are handed out on demand
+	/// and the least recently drawn one is reused when the atlas is full.
+	public static class Thumbnails
+	{
+		/// Same as RAIN_THUMBNAIL_SIZE and friends.
+		public const int Size = 64;
+		public const int AtlasSize = 1024;
+		public const int Columns = AtlasSize / Size;
+		public const int Slots = Columns * Columns;
+
+		/// The atlas, for ImGui.Image and friends.
+		public static IntPtr AtlasHandle { get; } = RainNative.Interop.Thumbnails_GetAtlas();
+
+		// Only written by the main thread between frames, once the slot's upload is recorded.
+		private static readonly unsafe uint* _ReadyTickets =
+			RainNative.Interop.Thumbnails_GetReadyTickets();
+
+		private static readonly Dictionary<ulong, int> _SlotByAsset = new();
+		private static readonly ulong[] _SlotAsset = new ulong[Slots];
+		private static readonly uint[] _SlotTicket = new uint[Slots];
+		private static readonly int[] _SlotLastUsed = new int[Slots];
+		private static int _UsedSlots = 0;
+		private static uint _NextTicket = 1;
+
+		private static int _AllocateSlot(int frame)
+		{
+			if (_UsedSlots < Slots) return _UsedSlots++;
+
+			int oldest = -1;
+			for (int i = 0; i < Slots; ++i)
+			{
+				// don't steal from something drawn this frame.
+				if (_SlotLastUsed[i] == frame) continue;
+				if (oldest < 0 || _SlotLastUsed[i] < _SlotLastUsed[oldest]) oldest = i;
+			}
+			if (oldest >= 0) _SlotByAsset.Remove(_SlotAsset[oldest]);
+			return oldest;
+		}
+
+		/// The atlas UVs of the thumbnail for an image file, requesting it if needed.
+		/// Returns false until the thumbnail is decoded and uploaded.
+		public static bool TryGet(AssetID id, string path, out Vector2 uv0, out Vector2 uv1)
+		{
+			uv0 = uv1 = default;
+			int frame = ImGui.GetFrameCount();
+
+			if (!_SlotByAsset.TryGetValue(id.Raw, out int slot))
+			{
+				slot = _AllocateSlot(frame);
+				if (slot < 0) return false;
+				_SlotByAsset.Add(id.Raw, slot);
+				_SlotAsset[slot] = id.Raw;
+				_SlotTicket[slot] = 0;
+			}
+			if (_SlotTicket[slot] == 0)
+			{
+				_SlotTicket[slot] = _NextTicket++;
+				RainNative.Interop.Thumbnails_Request(slot, _SlotTicket[slot], path);
+			}
+			_SlotLastUsed[slot] = frame;
+
+			unsafe
+			{
+				if (_ReadyTickets[slot] != _SlotTicket[slot]) return false;
+			}
+
+			// flipped like ImGuiUtil.Image.
+			float x = slot % Columns, y = slot / Columns;
+			uv0 = new Vector2(x, y + 1) / Columns;
+			uv1 = new Vector2(x + 1, y) / Columns;
+			return true;
+		}
+
+		/// Decode the thumbnail again next time it is drawn, e.g. after a reload.
+		public static void Invalidate(AssetID id)
+		{
+			if (_SlotByAsset.TryGetValue(id.Raw, out int slot)) _SlotTicket[slot] = 0;
+		}
+	}
+}
@@ -0,0 +1,18 @@
+using System;
+
+namespace RainEngine
+{
+	/// Frame timing, set by the main loop before each callback.
+	public static class Time
+	{
+		/// Seconds since the last frame.
+		public static float DeltaTime { get; internal set; }
+
+		/// Seconds per fixed step, OnFixedUpdate runs at this rate.
+		public static float FixedDeltaTime { get; internal set; }
+
+		/// How far rendering is between the last two fixed steps, [0, 1).
+		/// See TransformComponent.Interpolate.
+		public static float InterpolationAlpha { get; internal set; }
+	}
+}
@@ -0,0 +1,57 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <rain/assets.h>
+
+void rain_assets_init(struct rain_assets *this) {
+	// every slot starts out at generation 1, zeroed handles never match.
+	this->generations = malloc(RAIN_ASSETS_MAX * sizeof(*this->generations));
+	for (uint32_t i = 0; i < RAIN_ASSETS_MAX; ++i) this->generations[i] = 1;
+	this->data = calloc(RAIN_ASSETS_MAX, sizeof(*this->data));
+	this->free_slots = malloc(RAIN_ASSETS_MAX * sizeof(*this->free_slots));
+	this->free_count = 0;
+	this->used = 1;
+}
+
+void rain_assets_deinit(struct rain_assets *this) {
+	free(this->generations);
+	free(this->data);
+	free(this->free_slots);
+	*this = (struct rain_assets){};
+}
+
+static inline void rain__assets_bump_(struct rain_assets *this, uint32_t index) {
+	if (++this->generations[index] == 0) this->generations[index] = 1;
+}
+
+struct rain_asset_handle rain_assets_insert(struct rain_assets *this, void *data) {
+	uint32_t index;
+	if (this->free_count != 0) {
+		index = this->free_slots[--this->free_count];
+	} else if (this->used < RAIN_ASSETS_MAX) {
+		index = this->used++;
+	} else {
+		fprintf(stderr, "assets/ERR more than %d assets loaded.\n", RAIN_ASSETS_MAX);
+		return (struct rain_asset_handle){};
+	}
+	this->data[index] = data;
+	return (struct rain_asset_handle){ index, this->generations[index] };
+}
+
+void rain_assets_remove(struct rain_assets *this, struct rain_asset_handle handle) {
+	if (!rain_assets_is_valid(this, handle)) return;
+	this->data[handle.index] = nullptr;
+	rain__assets_bump_(this, handle.index);
+	this->free_slots[this->free_count++] = handle.index;
+}
+
+bool rain_assets_replace(
+	struct rain_assets *restrict this,
+	struct rain_asset_handle *restrict handle,
+	void *data
+) {
+	if (!rain_assets_is_valid(this, *handle)) return false;
+	this->data[handle->index] = data;
+	rain__assets_bump_(this, handle->index);
+	handle->generation = this->generations[handle->index];
+	return true;
+}
@@ -3,11 +3,21 @@
 
 #include <rain/window.h>
 #include <rain/renderer.h>
+#include <rain/assets.h>
+#include <rain/thumbnails.h>
+#include <rain/texture_streaming.h>
+#include <rain/texture_upload.h>
 
 extern struct rain_engine {
 	struct rain_window window;
 	struct rain_renderer renderer;
+	struct rain_assets assets;
+	struct rain_thumbnails thumbnails;
+	struct rain_texture_streaming texture_streaming;
+	struct rain_texture_uploads texture_uploads;
 	float delta_time;
+	/** the managed side has nothing to animate, wait for events. */
+	bool allow_idle;
 } rain__engine_;
 
 #endif // RAIN__ENGINE_H_
@@ -1,5 +1,6 @@
 #include <imgui.h>
 #include <stdio.h>
+#include <string.h>
 #include "imgui_binds.h"
 #define GLFW_INCLUDE_NONE
 #include <GLFW/glfw3.h>
@@ -8,13 +9,38 @@
 
 extern "C" {
 #include "engine.h"
+#include "render_thread.h"
+#include "upload_ring.h"
 }
 
+/** one draw command, resolved when recorded. */
+struct rain__imgui_cmd_ {
+	sg_image image;
+	bool font;
+	ImVec4 clip_rect;
+	unsigned int elem_count;
+	/** into the frame's index and vertex arrays. */
+	unsigned int idx_offset, vtx_offset;
+};
+
+/** copy of a frame's draw data for the render thread.
+    ImGui reuses its draw lists on the next NewFrame. */
+struct rain__imgui_frame_ {
+	ImVec2 disp_size;
+	int fb_width, fb_height;
+	ImVector<ImDrawVert> vertices;
+	ImVector<ImDrawIdx> indices;
+	ImVector<rain__imgui_cmd_> cmds;
+};
+
 static struct rain_imgui {
 	sg_bindings bind;
-	sg_pipeline pipeline;
-	sg_shader shader;
-	size_t max_vertices;
+	/** [0] samples RGBA textures, [1] the single-channel font atlas. */
+	sg_pipeline pipelines[2];
+	sg_shader shaders[2];
+	/** one is recorded while the render thread draws the other. */
+	rain__imgui_frame_ frames[2];
+	int frame;
 	/** NB: invalid. only stores sg_image. */
 	struct rain_texture font_rain_img;
 } im_;
@@ -23,47 +49,26 @@ struct rain_imgui_ub {
 	ImVec2 disp_size;
 };
 
-extern "C" {
-
-void rain_imgui_init(size_t max_vertices, struct rain_imgui_data *data) {
-	im_.max_vertices = max_vertices;
-	ImGui::CreateContext();
-	ImGui::StyleColorsDark();
-	ImGuiIO &io = ImGui::GetIO();
-	io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;
-	io.IniFilename = "data/imgui.ini";
-	io.Fonts->AddFontDefault();
-	
-	// Do something about this being specific
-	// to GLFW. Should this be in `window`? nah.
-	ImGui_ImplGlfw_InitForOther(
-		*(GLFWwindow**)rain__engine_.window.handle,
-		true
-	);
+/** sokol objects live on the render thread. */
+static void imgui_init_gfx_(void *) {
+	// vertices and indices go to the upload ring every frame, see `imgui_draw_`.
 
-	// dynamic vertex- and index-buffers for imgui-generated geometry
-	sg_buffer_desc vbuf_desc = { };
-	vbuf_desc.usage = SG_USAGE_STREAM;
-	vbuf_desc.size = im_.max_vertices * sizeof(ImDrawVert);
-	im_.bind.vertex_buffers[0] = sg_make_buffer(&vbuf_desc);
-
-	sg_buffer_desc ibuf_desc = { };
-	ibuf_desc.type = SG_BUFFERTYPE_INDEXBUFFER;
-	ibuf_desc.usage = SG_USAGE_STREAM;
-	ibuf_desc.size = im_.max_vertices * 3 * sizeof(ImDrawIdx);
-	im_.bind.index_buffer = sg_make_buffer(&ibuf_desc);
-
-	// font texture and sampler for imgui's default font
+	// font texture and sampler for imgui's default font.
+	// only coverage is stored, the colour comes from the vertices.
 	unsigned char *font_pixels;
 	int font_width, font_height;
-	io.Fonts->GetTexDataAsRGBA32(&font_pixels, &font_width, &font_height);
+	ImGuiIO &io = ImGui::GetIO();
+	io.Fonts->GetTexDataAsAlpha8(&font_pixels, &font_width, &font_height);
 
 	sg_image_desc img_desc = { };
 	img_desc.width = font_width;
 	img_desc.height = font_height;
-	img_desc.pixel_format = SG_PIXELFORMAT_RGBA8;
-	img_desc.data.subimage[0][0] = sg_range{ font_pixels, size_t(font_width * font_height * 4) };
+	img_desc.pixel_format = SG_PIXELFORMAT_R8;
+	img_desc.data.subimage[0][0] = sg_range{ font_pixels, size_t(font_width * font_height) };
 	im_.font_rain_img.image = sg_make_image(&img_desc);
+	im_.font_rain_img.width = font_width;
+	im_.font_rain_img.height = font_height;
+	im_.font_rain_img.format = SG_PIXELFORMAT_R8;
 
 	io.Fonts->SetTexID((void*)(uintptr_t)&im_.font_rain_img);
 
@@ -72,56 +77,104 @@ void rain_imgui_init(size_t max_vertices, struct rain_imgui_data *data) {
 	smp_desc.wrap_v = SG_WRAP_CLAMP_TO_EDGE;
 	im_.bind.fs.samplers[0] = sg_make_sampler(&smp_desc);
 
-	// shader object for imgui rendering
-	sg_shader_desc shd_desc = { };
-	auto &ub = shd_desc.vs.uniform_blocks[0];
-	ub.size = sizeof(rain_imgui_ub);
-	ub.uniforms[0].name = "disp_size";
-	ub.uniforms[0].type = SG_UNIFORMTYPE_FLOAT2;
-	shd_desc.vs.source =
-			"#version 330\n"
-			"uniform vec2 disp_size;\n"
-			"layout(location=0) in vec2 position;\n"
-			"layout(location=1) in vec2 texcoord0;\n"
-			"layout(location=2) in vec4 color0;\n"
-			"out vec2 uv;\n"
-			"out vec4 color;\n"
-			"void main() {\n"
-			"    gl_Position = vec4(((position/disp_size)-0.5)*vec2(2.0,-2.0), 0.5, 1.0);\n"
-			"    uv = texcoord0;\n"
-			"    color = color0;\n"
-			"}\n";
-	shd_desc.fs.images[0].used = true;
-	shd_desc.fs.samplers[0].used = true;
-	shd_desc.fs.image_sampler_pairs[0].used = true;
-	shd_desc.fs.image_sampler_pairs[0].glsl_name = "tex";
-	shd_desc.fs.image_sampler_pairs[0].image_slot = 0;
-	shd_desc.fs.image_sampler_pairs[0].sampler_slot = 0;
-	shd_desc.fs.source =
-			"#version 330\n"
-			"uniform sampler2D tex;\n"
-			"in vec2 uv;\n"
-			"in vec4 color;\n"
-			"out vec4 frag_color;\n"
-			"void main() {\n"
-			"    frag_color = texture(tex, uv) * color;\n"
-			"}\n";
-	im_.shader = sg_make_shader(&shd_desc);
-
-	// pipeline object for imgui rendering
-	sg_pipeline_desc pip_desc = { };
-	pip_desc.layout.buffers[0].stride = sizeof(ImDrawVert);
-	auto &attrs = pip_desc.layout.attrs;
-	attrs[0].format = SG_VERTEXFORMAT_FLOAT2;
-	attrs[1].format = SG_VERTEXFORMAT_FLOAT2;
-	attrs[2].format = SG_VERTEXFORMAT_UBYTE4N;
-	pip_desc.shader = im_.shader;
-	pip_desc.index_type = SG_INDEXTYPE_UINT16;
-	pip_desc.colors[0].blend.enabled = true;
-	pip_desc.colors[0].blend.src_factor_rgb = SG_BLENDFACTOR_SRC_ALPHA;
-	pip_desc.colors[0].blend.dst_factor_rgb = SG_BLENDFACTOR_ONE_MINUS_SRC_ALPHA;
-	pip_desc.colors[0].write_mask = SG_COLORMASK_RGB;
-	im_.pipeline = sg_make_pipeline(&pip_desc);
+	// shader objects for imgui rendering, the font atlas
+	// only has a red channel which is used as alpha.
+	const char *fs_sources[2] = {
+		"#version 330\n"
+		"uniform sampler2D tex;\n"
+		"in vec2 uv;\n"
+		"in vec4 color;\n"
+		"out vec4 frag_color;\n"
+		"void main() {\n"
+		"    frag_color = texture(tex, uv) * color;\n"
+		"}\n",
+		"#version 330\n"
+		"uniform sampler2D tex;\n"
+		"in vec2 uv;\n"
+		"in vec4 color;\n"
+		"out vec4 frag_color;\n"
+		"void main() {\n"
+		"    frag_color = vec4(1.0, 1.0, 1.0, texture(tex, uv).r) * color;\n"
+		"}\n",
+	};
+	for (int i = 0; i < 2; ++i) {
+		sg_shader_desc shd_desc = { };
+		auto &ub = shd_desc.vs.uniform_blocks[0];
+		ub.size = sizeof(rain_imgui_ub);
+		ub.uniforms[0].name = "disp_size";
+		ub.uniforms[0].type = SG_UNIFORMTYPE_FLOAT2;
+		shd_desc.vs.source =
+				"#version 330\n"
+				"uniform vec2 disp_size;\n"
+				"layout(location=0) in vec2 position;\n"
+				"layout(location=1) in vec2 texcoord0;\n"
+				"layout(location=2) in vec4 color0;\n"
+				"out vec2 uv;\n"
+				"out vec4 color;\n"
+				"void main() {\n"
+				"    gl_Position = vec4(((position/disp_size)-0.5)*vec2(2.0,-2.0), 0.5, 1.0);\n"
+				"    uv = texcoord0;\n"
+				"    color = color0;\n"
+				"}\n";
+		shd_desc.fs.images[0].used = true;
+		shd_desc.fs.samplers[0].used = true;
+		shd_desc.fs.image_sampler_pairs[0].used = true;
+		shd_desc.fs.image_sampler_pairs[0].glsl_name = "tex";
+		shd_desc.fs.image_sampler_pairs[0].image_slot = 0;
+		shd_desc.fs.image_sampler_pairs[0].sampler_slot = 0;
+		shd_desc.fs.source = fs_sources[i];
+		im_.shaders[i] = sg_make_shader(&shd_desc);
+
+		// pipeline object for imgui rendering
+		sg_pipeline_desc pip_desc = { };
+		pip_desc.layout.buffers[0].stride = sizeof(ImDrawVert);
+		auto &attrs = pip_desc.layout.attrs;
+		attrs[0].format = SG_VERTEXFORMAT_FLOAT2;
+		attrs[1].format = SG_VERTEXFORMAT_FLOAT2;
+		attrs[2].format = SG_VERTEXFORMAT_UBYTE4N;
+		pip_desc.shader = im_.shaders[i];
+		// follows imconfig.h
+		pip_desc.index_type = sizeof(ImDrawIdx) == 4
+			? SG_INDEXTYPE_UINT32
+			: SG_INDEXTYPE_UINT16;
+		pip_desc.colors[0].blend.enabled = true;
+		pip_desc.colors[0].blend.src_factor_rgb = SG_BLENDFACTOR_SRC_ALPHA;
+		pip_desc.colors[0].blend.dst_factor_rgb = SG_BLENDFACTOR_ONE_MINUS_SRC_ALPHA;
+		pip_desc.colors[0].write_mask = SG_COLORMASK_RGB;
+		im_.pipelines[i] = sg_make_pipeline(&pip_desc);
+	}
+}
+
+static void imgui_deinit_gfx_(void *) {
+	for (int i = 0; i < 2; ++i) {
+		sg_destroy_pipeline(im_.pipelines[i]);
+		sg_destroy_shader(im_.shaders[i]);
+	}
+	sg_destroy_image(im_.font_rain_img.image);
+	sg_destroy_sampler(im_.bind.fs.samplers[0]);
+}
+
+static void imgui_draw_(void *payload);
+
+extern "C" {
+
+void rain_imgui_init(struct rain_imgui_data *data) {
+	ImGui::CreateContext();
+	ImGui::StyleColorsDark();
+	ImGuiIO &io = ImGui::GetIO();
+	io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;
+	io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;
+	io.IniFilename = "data/imgui.ini";
+	io.Fonts->AddFontDefault();
+	
+	// Do something about this being specific
+	// to GLFW. Should this be in `window`? nah.
+	ImGui_ImplGlfw_InitForOther(
+		*(GLFWwindow**)rain__engine_.window.handle,
+		true
+	);
+
+	rain_render_thread_sync(&imgui_init_gfx_, nullptr);
 
 	data->context = ImGui::GetCurrentContext();
 	ImGui::GetAllocatorFunctions(
@@ -134,13 +187,12 @@ void rain_imgui_init(size_t max_vertices, struct rain_imgui_data *data) {
 }
 
 void rain_imgui_deinit() {
-	sg_destroy_pipeline(im_.pipeline);
-	sg_destroy_buffer(im_.bind.index_buffer);
-	sg_destroy_buffer(im_.bind.vertex_buffers[0]);
-	sg_destroy_buffer(im_.bind.vertex_buffers[0]);
-	sg_destroy_shader(im_.shader);
-	sg_destroy_image(im_.bind.fs.images[0]);
-	sg_destroy_sampler(im_.bind.fs.samplers[0]);
+	rain_render_thread_sync(&imgui_deinit_gfx_, nullptr);
+	for (rain__imgui_frame_ &frame : im_.frames) {
+		frame.vertices.clear();
+		frame.indices.clear();
+		frame.cmds.clear();
+	}
 	ImGui_ImplGlfw_Shutdown();
 	ImGui::DestroyContext();
 }
@@ -157,71 +209,109 @@ void rain_imgui_begin_render() {
 	ImGui::BeginDragDropSource();
 }
 
-static void imgui_draw_(ImDrawData *draw_data);
+/** copy the draw data of this frame, it is drawn on the render thread. */
+static void imgui_record_(ImDrawData *draw_data, rain__imgui_frame_ *frame) {
+	frame->disp_size = ImGui::GetIO().DisplaySize;
+	rain_window_get_fb_size(&rain__engine_.window, &frame->fb_width, &frame->fb_height);
+	frame->cmds.resize(0);
+
+	// gather every draw list so each buffer is updated once.
+	frame->vertices.resize(draw_data->TotalVtxCount);
+	frame->indices.resize(draw_data->TotalIdxCount);
+	ImDrawVert *vtx_dst = frame->vertices.Data;
+	ImDrawIdx *idx_dst = frame->indices.Data;
+	unsigned int base_vertex = 0, base_element = 0;
+	for (int cl_index = 0; cl_index < draw_data->CmdListsCount; cl_index++) {
+		const ImDrawList* cl = draw_data->CmdLists[cl_index];
+		memcpy(vtx_dst, cl->VtxBuffer.Data, cl->VtxBuffer.Size * sizeof(ImDrawVert));
+		memcpy(idx_dst, cl->IdxBuffer.Data, cl->IdxBuffer.Size * sizeof(ImDrawIdx));
+		vtx_dst += cl->VtxBuffer.Size;
+		idx_dst += cl->IdxBuffer.Size;
+
+		for (const ImDrawCmd &pcmd : cl->CmdBuffer) {
+			if (pcmd.UserCallback) {
+				// `imgui_draw_` owns the state from its first command to its last.
+				if (pcmd.UserCallback == ImDrawCallback_ResetRenderState) continue;
+				// they expect to run between the draws, which are on the render thread.
+				IM_ASSERT(!"user callbacks are not supported.");
+				continue;
+			}
+			if (pcmd.ElemCount == 0) {
+				continue;
+			}
+			// the texture may be gone by the time this is drawn.
+			rain_texture *img = (rain_texture*)(void*)(uintptr_t)pcmd.GetTexID();
+			// ImGui has no idea how large it draws them, ask for every mip.
+			if (img->stream) rain_texture_stream_request(img->stream, 0);
+			rain__imgui_cmd_ cmd;
+			cmd.image = img->image;
+			cmd.font = img == &im_.font_rain_img;
+			cmd.clip_rect = pcmd.ClipRect;
+			cmd.elem_count = pcmd.ElemCount;
+			cmd.idx_offset = base_element + pcmd.IdxOffset;
+			cmd.vtx_offset = base_vertex + pcmd.VtxOffset;
+			frame->cmds.push_back(cmd);
+		}
+		base_vertex += cl->VtxBuffer.Size;
+		base_element += cl->IdxBuffer.Size;
+	}
+}
 
 void rain_imgui_end_render() {
 	ImGui::Render();
-	imgui_draw_(ImGui::GetDrawData());
-	int width, height;
-	rain_window_get_fb_size(&rain__engine_.window, &width, &height);
-	sg_apply_scissor_rect(0, 0, width, height, true);
+	rain__imgui_frame_ *frame = &im_.frames[im_.frame];
+	im_.frame = !im_.frame;
+	imgui_record_(ImGui::GetDrawData(), frame);
+	*(rain__imgui_frame_ **)rain_render_thread_push(&imgui_draw_, sizeof(frame)) = frame;
 }
 
-static void imgui_draw_(ImDrawData *draw_data) {
-	assert(draw_data);
-	if (draw_data->CmdListsCount == 0) {
+}
+
+static void imgui_draw_(void *payload) {
+	rain__imgui_frame_ *frame = *(rain__imgui_frame_ **)payload;
+	if (frame->cmds.empty()) {
 		return;
 	}
 
-	// render the command list
-	sg_apply_pipeline(im_.pipeline);
+	// both pushed before binding either, a push may move the ring.
+	rain_upload vertices = rain_upload_ring_push(frame->vertices.Data, frame->vertices.size_in_bytes());
+	rain_upload indices = rain_upload_ring_push(frame->indices.Data, frame->indices.size_in_bytes());
+	im_.bind.vertex_buffers[0] = vertices.vertex_buffer;
+	im_.bind.index_buffer = indices.index_buffer;
+	im_.bind.index_buffer_offset = indices.offset;
+
 	rain_imgui_ub vs_params;
-	vs_params.disp_size.x = ImGui::GetIO().DisplaySize.x;
-	vs_params.disp_size.y = ImGui::GetIO().DisplaySize.y;
-	sg_apply_uniforms(SG_SHADERSTAGE_VS, 0, SG_RANGE(vs_params));
-	for (int cl_index = 0; cl_index < draw_data->CmdListsCount; cl_index++) {
-		const ImDrawList* cl = draw_data->CmdLists[cl_index];
+	vs_params.disp_size = frame->disp_size;
 
-		// append vertices and indices to buffers, record start offsets in resource binding struct
-		const uint32_t vtx_size = cl->VtxBuffer.size() * sizeof(ImDrawVert);
-		const uint32_t idx_size = cl->IdxBuffer.size() * sizeof(ImDrawIdx);
-		const uint32_t vb_offset = sg_append_buffer(im_.bind.vertex_buffers[0], { &cl->VtxBuffer.front(), vtx_size });
-		const uint32_t ib_offset = sg_append_buffer(im_.bind.index_buffer, { &cl->IdxBuffer.front(), idx_size });
-		/* don't render anything if the buffer is in overflow state (this is also
-				checked internally in sokol_gfx, draw calls that attempt from
-				overflowed buffers will be silently dropped)
-		*/
-		if (sg_query_buffer_overflow(im_.bind.vertex_buffers[0]) ||
-				sg_query_buffer_overflow(im_.bind.index_buffer))
-		{
-			continue;
+	// render the commands, only touching state when it changes.
+	int pipeline = -1;
+	sg_image last_image = { SG_INVALID_ID };
+	size_t last_vtx_offset = SIZE_MAX;
+	for (const rain__imgui_cmd_ &cmd : frame->cmds) {
+		const int cmd_pipeline = cmd.font;
+		const size_t vtx_offset = vertices.offset + cmd.vtx_offset * sizeof(ImDrawVert);
+		bool rebind = false;
+		if (cmd_pipeline != pipeline) {
+			pipeline = cmd_pipeline;
+			sg_apply_pipeline(im_.pipelines[pipeline]);
+			sg_apply_uniforms(SG_SHADERSTAGE_VS, 0, SG_RANGE(vs_params));
+			rebind = true;
 		}
-
-		im_.bind.vertex_buffer_offsets[0] = vb_offset;
-		im_.bind.index_buffer_offset = ib_offset;
-
-		int base_element = 0;
-		sg_image last_image = { SG_INVALID_ID };
-		for (const ImDrawCmd &pcmd : cl->CmdBuffer) {
-			if (pcmd.UserCallback) {
-				pcmd.UserCallback(cl, &pcmd);
-			} else {
-				rain_texture *img = (rain_texture*)(void*)(uintptr_t)pcmd.GetTexID();
-				if (img->image.id != last_image.id) {
-					last_image = im_.bind.fs.images[0] = img->image;
-					sg_apply_bindings(&im_.bind);
-				}
-				const int scissor_x = int(pcmd.ClipRect.x);
-				const int scissor_y = int(pcmd.ClipRect.y);
-				const int scissor_w = int(pcmd.ClipRect.z - pcmd.ClipRect.x);
-				const int scissor_h = int(pcmd.ClipRect.w - pcmd.ClipRect.y);
-				sg_apply_scissor_rect(scissor_x, scissor_y, scissor_w, scissor_h, true);
-				sg_draw(base_element, pcmd.ElemCount, 1);
-			}
-			base_element += pcmd.ElemCount;
+		if (rebind || cmd.image.id != last_image.id || vtx_offset != last_vtx_offset) {
+			last_image = im_.bind.fs.images[0] = cmd.image;
+			last_vtx_offset = vtx_offset;
+			im_.bind.vertex_buffer_offsets[0] = (int)vtx_offset;
+			sg_apply_bindings(&im_.bind);
 		}
-	}
-}
 
+		const int scissor_x = int(cmd.clip_rect.x);
+		const int scissor_y = int(cmd.clip_rect.y);
+		const int scissor_w = int(cmd.clip_rect.z - cmd.clip_rect.x);
+		const int scissor_h = int(cmd.clip_rect.w - cmd.clip_rect.y);
+		sg_apply_scissor_rect(scissor_x, scissor_y, scissor_w, scissor_h, true);
+		sg_draw(cmd.idx_offset, cmd.elem_count, 1);
+	}
+	sg_apply_scissor_rect(0, 0, frame->fb_width, frame->fb_height, true);
+	// quads drawn after this have to apply their own state again.
+	rain_renderer_reset_state(&rain__engine_.renderer);
 }
-
@@ -16,7 +16,7 @@ struct rain_imgui_data {
 	void *user_ptr;
 };
 
-void rain_imgui_init(size_t max_vertices, struct rain_imgui_data *data);
+void rain_imgui_init(struct rain_imgui_data *data);
 void rain_imgui_deinit();
 void rain_imgui_begin_render();
 void rain_imgui_end_render();
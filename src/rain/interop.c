@@ -1,11 +1,15 @@
 #include <rain/camera.h>
 #include <rain/window.h>
 #include <rain/renderer.h>
+#include <rain/jobs.h>
+#include <math.h>
 #include <mono/jit/jit.h>
 #include <mono/metadata/assembly.h>
 #include <mono/metadata/debug-helpers.h>
 #include "engine.h"
 #include "imgui_binds.h"
+#include "profiler.h"
+#include "render_thread.h"
 
 static struct {
 	MonoDomain *domain;
@@ -62,6 +66,14 @@ struct rain_window *RMIF_(Engine_GetWindow)() {
 	return &rain__engine_.window;
 }
 
+static void RMIF_(Engine_SetAllowIdle)(mono_bool allow) {
+	rain__engine_.allow_idle = allow;
+}
+
+static void RMIF_(Engine_Wake)() {
+	rain_window_wake(&rain__engine_.window);
+}
+
 void RMIF_(Window_SetTitle)(struct rain_window *o, MonoString *v) {
 	char *utf8 = mono_string_to_utf8(v);
 	rain_window_set_title(o, utf8);
@@ -76,6 +88,10 @@ bool RMIF_(Window_IsKeyDown)(struct rain_window *o, int keycode) {
 	return rain_window_is_key_down(o, keycode);
 }
 
+void RMIF_(Window_GetKeys)(struct rain_window *o, bool *out_down, int count) {
+	rain_window_get_keys(o, out_down, count);
+}
+
 void RMIF_(Window_GetFramebufferSize)(struct rain_window *o, rain_float2 *out_size) {
 	int width, height;
 	rain_window_get_fb_size(o, &width, &height);
@@ -106,7 +122,7 @@ static void RMIF_(Texture_Init)(
 	struct rain_texture *o,
 	struct RMIF_(TextureDesc) *desc
 ) {
-	o->image = sg_make_image(&(sg_image_desc){
+	o->image = rain_render_thread_make_image(&(sg_image_desc){
 		.render_target = desc->IsRenderTarget,
 		.pixel_format = desc->PixelFormat,
 		.width = desc->Dimensions.Width,
@@ -125,7 +141,11 @@ static void RMIF_(Texture_FromFile)(
 	int usage
 ) {
 	char *utf8_path = mono_string_to_utf8(path);
-	rain_texture_from_file(o, utf8_path, format, usage);
+	if (usage == SG_USAGE_IMMUTABLE) {
+		rain_texture_streaming_load(&rain__engine_.texture_streaming, o, utf8_path, format);
+	} else {
+		rain_texture_from_file(o, utf8_path, format, usage);
+	}
 	mono_free(utf8_path);
 }
 
@@ -138,17 +158,28 @@ static void RMIF_(Texture_GetSize)(
 }
 
 static int RMIF_(Texture_GetFormat)(struct rain_texture *o) {
-	return o->format;
-}
-
-void RMIF_(Window_SetFramebufferSize)(struct rain_window *o, rain_float2 *ref_size) {
-	fprintf(stderr, "rr/ERR setting window framebuffer size not supported.\n");
+	return o->channels;
 }
 
 struct RMIF_(Renderer_Rect) {
 	uint64_t OffsetX, OffsetY, Width, Height;
 };
 
+static mono_bool RMIF_(Texture_Update)(
+	struct rain_texture *o,
+	struct RMIF_(Renderer_Rect) *rect,
+	const uint8_t *pixels,
+	int size
+) {
+	return size >= 0 && rain_texture_update(&rain__engine_.texture_uploads, o,
+		(int)rect->OffsetX, (int)rect->OffsetY, (int)rect->Width, (int)rect->Height,
+		pixels, (size_t)size);
+}
+
+void RMIF_(Window_SetFramebufferSize)(struct rain_window *o, rain_float2 *ref_size) {
+	fprintf(stderr, "rr/ERR setting window framebuffer size not supported.\n");
+}
+
 static void RMIF_(Renderer_RenderTexturedQuad)(
 	struct rain_texture *tex,
 	sg_sampler samp,
@@ -171,6 +202,84 @@ static void RMIF_(Renderer_RenderTexturedQuad)(
 	);
 }
 
+struct RMIF_(Renderer_Quad) {
+	rain_float4x4 Transform;
+	rain_float4 Color;
+	struct rain_texture *Texture;
+	/** null picks the builtin colored or textured material. */
+	struct rain_material *Material;
+	sg_sampler Sampler;
+	uint32_t _Pad[3];
+	struct RMIF_(Renderer_Rect) Rect;
+};
+
+/** pixels of the pass being recorded, for picking mips. */
+static rain_float2 rain__pass_size_;
+
+/** ask for the mip whose texels are about as large as the quad's pixels. */
+static void rain__request_texture_mip_(
+	const struct rain_texture *texture,
+	const struct RMIF_(Renderer_Rect) *rect,
+	const rain_float4x4 *trans
+) {
+	struct rain_texture_stream *stream = texture->stream;
+	if (stream == nullptr) return;
+	// the quad spans -1..1, its axes are the first two columns, the
+	// center the last one.
+	const struct rain_float4 *r = trans->rows;
+	float w = r[3].w;
+	if (w <= 0.0f) return;
+	float half_w = rain__pass_size_.x * 0.5f, half_h = rain__pass_size_.y * 0.5f;
+	float x_px = 2.0f * hypotf(r[0].x * half_w, r[1].x * half_h) / w;
+	float y_px = 2.0f * hypotf(r[0].y * half_w, r[1].y * half_h) / w;
+	float texels_x = rect->Width ? rect->Width : texture->width;
+	float texels_y = rect->Height ? rect->Height : texture->height;
+	float ratio_x = texels_x / (x_px > 1.0f ? x_px : 1.0f);
+	float ratio_y = texels_y / (y_px > 1.0f ? y_px : 1.0f);
+	float ratio = ratio_x < ratio_y ? ratio_x : ratio_y;
+	rain_texture_stream_request(stream, ratio > 1.0f ? (int)log2f(ratio) : 0);
+}
+
+/** a merged `RenderList`, in draw order. */
+static void RMIF_(Renderer_RenderQuads)(struct RMIF_(Renderer_Quad) *quads, int count) {
+	for (int i = 0; i < count; ++i) {
+		struct RMIF_(Renderer_Quad) *quad = &quads[i];
+		struct rain_renderer *renderer = &rain__engine_.renderer;
+		const struct rain_material *material = quad->Material;
+		if (material == nullptr) {
+			material = quad->Texture
+				? &renderer->builtin_.textured_quad_material
+				: &renderer->builtin_.colored_quad_material;
+		}
+		if (material->shader->textured && quad->Texture == nullptr) {
+			fprintf(stderr, "rr/ERR textured material %u drawn without a texture.\n", material->id);
+			continue;
+		}
+		if (quad->Texture) rain__request_texture_mip_(quad->Texture, &quad->Rect, &quad->Transform);
+		struct rain_renderer_rect rect = {
+			.offset_x = quad->Rect.OffsetX,
+			.offset_y = quad->Rect.OffsetY,
+			.width = quad->Rect.Width,
+			.height = quad->Rect.Height
+		};
+		rain_renderer_render_quad(
+			renderer, material,
+			quad->Texture, quad->Sampler,
+			&rect,
+			&quad->Color,
+			&quad->Transform
+		);
+	}
+}
+
+static void RMIF_(Renderer_GetStats)(struct rain_renderer_stats *out_stats) {
+	rain_renderer_get_stats(&rain__engine_.renderer, out_stats);
+}
+
+static void RMIF_(Renderer_SetDebugView)(int view) {
+	rain_renderer_set_debug_view(&rain__engine_.renderer, (enum rain_renderer_debug_view)view);
+}
+
 static sg_sampler RMIF_(Renderer_GetBuiltinSampler)(
 	[[maybe_unused]] unsigned int id
 ) {
@@ -182,6 +291,54 @@ struct rain__render_pass_ {
 	struct rain_texture *color, *depth_stencil;
 };
 
+static struct rain_shader *RMIF_(Shader_Create)(
+	MonoString *label,
+	MonoString *fs_body,
+	int param_count,
+	mono_bool textured
+) {
+	char *utf8_label = mono_string_to_utf8(label);
+	char *utf8_body = mono_string_to_utf8(fs_body);
+	struct rain_shader *o = calloc(1, sizeof(*o));
+	rain_shader_init(o, utf8_label, utf8_body, (uint32_t)param_count, textured);
+	mono_free(utf8_body);
+	mono_free(utf8_label);
+	return o;
+}
+
+static struct rain_material *RMIF_(Material_Create)(
+	struct rain_shader *shader,
+	uint32_t blend,
+	mono_bool depth_test,
+	mono_bool depth_write
+) {
+	struct rain_material *o = malloc(sizeof(*o));
+	rain_material_init(o, shader, (struct rain_material_state){
+		.blend = blend,
+		.depth_test = depth_test,
+		.depth_write = depth_write,
+	});
+	return o;
+}
+
+static uint32_t RMIF_(Material_GetId)(struct rain_material *o) {
+	return o->id;
+}
+
+static void RMIF_(Material_SetParams)(
+	struct rain_material *o,
+	int first,
+	rain_float4 *values,
+	int count
+) {
+	if (first < 0 || count <= 0) return;
+	rain_material_set_params(o, (uint32_t)first, (uint32_t)count, values);
+}
+
+static void RMIF_(Material_DestroyAndFree)(struct rain_material *o) {
+	rain_material_destroy_and_free(o);
+}
+
 static struct rain__render_pass_ *RMIF_(RenderPass_Alloc)(
 	struct rain_texture *color,
 	struct rain_texture *depthStencil
@@ -189,7 +346,7 @@ static struct rain__render_pass_ *RMIF_(RenderPass_Alloc)(
 	struct rain__render_pass_ *r = calloc(1, sizeof(*r));
 	r->color = color;
 	r->depth_stencil = depthStencil;
-	r->pass = sg_make_pass(&(sg_pass_desc){
+	r->pass = rain_render_thread_make_pass(&(sg_pass_desc){
 		.color_attachments[0].image = r->color->image,
 		.depth_stencil_attachment.image = 
 			r->depth_stencil ? r->depth_stencil->image : (sg_image){}
@@ -198,59 +355,138 @@ static struct rain__render_pass_ *RMIF_(RenderPass_Alloc)(
 }
 
 static void RMIF_(RenderPass_DestroyAndFree)(struct rain__render_pass_ *o) {
-	sg_destroy_pass(o->pass);
+	rain_render_thread_destroy_pass(o->pass);
 	free(o);
 }
 
-static void RMIF_(Renderer_BeginPass)(
-	struct rain__render_pass_ *pass,
+// recorded for the render thread, see render_thread.h.
+struct rain__begin_pass_cmd_ {
+	/** SG_INVALID_ID for the default pass. */
+	sg_pass pass;
+	sg_pass_action action;
+	int width, height;
+};
+
+static void rain__begin_pass_(void *payload) {
+	struct rain__begin_pass_cmd_ *cmd = payload;
+	if (cmd->pass.id != SG_INVALID_ID) sg_begin_pass(cmd->pass, &cmd->action);
+	else sg_begin_default_pass(&cmd->action, cmd->width, cmd->height);
+	rain_renderer_reset_state(&rain__engine_.renderer);
+}
+
+static struct rain__begin_pass_cmd_ *rain__push_begin_pass_(
 	mono_bool clear,
 	rain_float4 *color
 ) {
-	sg_pass_action action = {};
+	struct rain__begin_pass_cmd_ *cmd =
+		rain_render_thread_push(&rain__begin_pass_, sizeof(*cmd));
+	*cmd = (struct rain__begin_pass_cmd_){};
+	// depth only sorts the opaque and translucent draws of this pass.
+	cmd->action.depth.load_action = SG_LOADACTION_CLEAR;
+	cmd->action.depth.clear_value = 1.0f;
 	if (clear) {
-		action.colors[0].load_action = SG_LOADACTION_CLEAR;
-		action.colors[0].clear_value.r = color->x;
-		action.colors[0].clear_value.g = color->y;
-		action.colors[0].clear_value.b = color->z;
-		action.colors[0].clear_value.a = color->w;
+		cmd->action.colors[0].load_action = SG_LOADACTION_CLEAR;
+		cmd->action.colors[0].clear_value.r = color->x;
+		cmd->action.colors[0].clear_value.g = color->y;
+		cmd->action.colors[0].clear_value.b = color->z;
+		cmd->action.colors[0].clear_value.a = color->w;
 	}
-	sg_begin_pass(pass->pass, &action);
+	return cmd;
+}
+
+static void RMIF_(Renderer_BeginPass)(
+	struct rain__render_pass_ *pass,
+	mono_bool clear,
+	rain_float4 *color
+) {
+	rain__push_begin_pass_(clear, color)->pass = pass->pass;
+	if (pass->color) rain__pass_size_ = (rain_float2){ pass->color->width, pass->color->height };
 }
 
 static void RMIF_(Renderer_BeginDefaultPass)(
 	mono_bool clear,
 	rain_float4 *color
 ) {
-	sg_pass_action action = {};
-	if (clear) {
-		action.colors[0].load_action = SG_LOADACTION_CLEAR;
-		action.colors[0].clear_value.r = color->x;
-		action.colors[0].clear_value.g = color->y;
-		action.colors[0].clear_value.b = color->z;
-		action.colors[0].clear_value.a = color->w;
-	}
-	int width, height;
-	rain_window_get_fb_size(&rain__engine_.window, &width, &height);
-	sg_begin_default_pass(&action, width, height);
+	struct rain__begin_pass_cmd_ *cmd = rain__push_begin_pass_(clear, color);
+	rain_window_get_fb_size(&rain__engine_.window, &cmd->width, &cmd->height);
+	rain__pass_size_ = (rain_float2){ cmd->width, cmd->height };
 }
 
-static void RMIF_(Renderer_EndPass)() {
+static void rain__end_pass_(void *payload) {
 	sg_end_pass();
 }
 
+static void RMIF_(Renderer_EndPass)() {
+	rain_render_thread_push(&rain__end_pass_, 0);
+}
+
+static const uint32_t *RMIF_(Assets_GetGenerations)() {
+	return rain__engine_.assets.generations;
+}
+
+static void RMIF_(Assets_Insert)(void *data, struct rain_asset_handle *out_handle) {
+	*out_handle = rain_assets_insert(&rain__engine_.assets, data);
+}
+
+static void RMIF_(Assets_Remove)(struct rain_asset_handle *handle) {
+	rain_assets_remove(&rain__engine_.assets, *handle);
+}
+
+static mono_bool RMIF_(Assets_Replace)(struct rain_asset_handle *handle, void *data) {
+	return rain_assets_replace(&rain__engine_.assets, handle, data);
+}
+
+static int RMIF_(Jobs_GetWorkerCount)() {
+	return rain_jobs_worker_count();
+}
+
+/** `fn` is a managed delegate turned into a function pointer. blocks,
+    the calling thread runs jobs too. */
+static void RMIF_(Jobs_ParallelFor)(rain_job_fn fn, void *data, uint64_t count, uint64_t batch) {
+	struct rain_jobs_counter counter = {};
+	rain_jobs_parallel_for(fn, data, count, batch, &counter, nullptr);
+	rain_jobs_wait(&counter);
+}
+
+static struct rain_texture *RMIF_(Thumbnails_GetAtlas)() {
+	return &rain__engine_.thumbnails.atlas;
+}
+
+static const uint32_t *RMIF_(Thumbnails_GetReadyTickets)() {
+	return rain__engine_.thumbnails.ready_tickets;
+}
+
+static void RMIF_(Thumbnails_Request)(int slot, uint32_t ticket, MonoString *path) {
+	char *utf8_path = mono_string_to_utf8(path);
+	rain_thumbnails_request(&rain__engine_.thumbnails, slot, ticket, utf8_path);
+	mono_free(utf8_path);
+}
+
+static int RMIF_(Profiler_GetMode)() {
+	return rain_profiler_get_mode();
+}
+
+static void RMIF_(Profiler_GetFrameStats)(struct rain_profiler_frame_stats *out_stats) {
+	rain_profiler_get_frame_stats(out_stats);
+}
+
+static int RMIF_(Profiler_GetTypeStats)(struct rain_profiler_type_stats *out_types, int max) {
+	return rain_profiler_get_type_stats(out_types, max);
+}
+
+static void RMIF_(Profiler_ResetTypeStats)() {
+	rain_profiler_reset_type_stats();
+}
+
 struct RMIF_(ImGUI_Data) {
 	void *Context;
 	void *AllocFunc;
 	void *FreeFunc;
 };
 
-static void RMIF_(ImGUI_Init)(
-	unsigned long maxVertices,
-	struct RMIF_(ImGUI_Data) *p
-) {
+static void RMIF_(ImGUI_Init)(struct RMIF_(ImGUI_Data) *p) {
 	struct rain_imgui_data data;
-	rain_imgui_init(maxVertices, &data);
+	rain_imgui_init(&data);
 	p->Context = data.context;
 	p->AllocFunc = data.alloc_func;
 	p->FreeFunc = data.free_func;
@@ -282,17 +518,23 @@ void rain_bind_mono_interop(MonoDomain *domain) {
 
 	RAIN__ADD_ICALL_(Renderer_RenderColoredQuad);
 	RAIN__ADD_ICALL_(Renderer_RenderTexturedQuad);
+	RAIN__ADD_ICALL_(Renderer_RenderQuads);
+	RAIN__ADD_ICALL_(Renderer_GetStats);
+	RAIN__ADD_ICALL_(Renderer_SetDebugView);
 	RAIN__ADD_ICALL_(Renderer_GetBuiltinSampler);
 	RAIN__ADD_ICALL_(Renderer_BeginPass);
 	RAIN__ADD_ICALL_(Renderer_BeginDefaultPass);
 	RAIN__ADD_ICALL_(Renderer_EndPass);
 
 	RAIN__ADD_ICALL_(Engine_GetWindow);
+	RAIN__ADD_ICALL_(Engine_SetAllowIdle);
+	RAIN__ADD_ICALL_(Engine_Wake);
 	RAIN__ADD_ICALL_(Window_SetTitle);
 	RAIN__ADD_ICALL_(Window_GetTitle);
 	RAIN__ADD_ICALL_(Window_SetFramebufferSize);
 	RAIN__ADD_ICALL_(Window_GetFramebufferSize);
 	RAIN__ADD_ICALL_(Window_IsKeyDown);
+	RAIN__ADD_ICALL_(Window_GetKeys);
 
 	RAIN__ADD_ICALL_(Texture_Alloc);
 	RAIN__ADD_ICALL_(Texture_DestroyAndFree);
@@ -300,10 +542,34 @@ void rain_bind_mono_interop(MonoDomain *domain) {
 	RAIN__ADD_ICALL_(Texture_Init);
 	RAIN__ADD_ICALL_(Texture_GetSize);
 	RAIN__ADD_ICALL_(Texture_GetFormat);
+	RAIN__ADD_ICALL_(Texture_Update);
+
+	RAIN__ADD_ICALL_(Shader_Create);
+	RAIN__ADD_ICALL_(Material_Create);
+	RAIN__ADD_ICALL_(Material_GetId);
+	RAIN__ADD_ICALL_(Material_SetParams);
+	RAIN__ADD_ICALL_(Material_DestroyAndFree);
 
 	RAIN__ADD_ICALL_(RenderPass_Alloc);
 	RAIN__ADD_ICALL_(RenderPass_DestroyAndFree);
 
+	RAIN__ADD_ICALL_(Assets_GetGenerations);
+	RAIN__ADD_ICALL_(Assets_Insert);
+	RAIN__ADD_ICALL_(Assets_Remove);
+	RAIN__ADD_ICALL_(Assets_Replace);
+
+	RAIN__ADD_ICALL_(Jobs_GetWorkerCount);
+	RAIN__ADD_ICALL_(Jobs_ParallelFor);
+
+	RAIN__ADD_ICALL_(Thumbnails_GetAtlas);
+	RAIN__ADD_ICALL_(Thumbnails_GetReadyTickets);
+	RAIN__ADD_ICALL_(Thumbnails_Request);
+
+	RAIN__ADD_ICALL_(Profiler_GetMode);
+	RAIN__ADD_ICALL_(Profiler_GetFrameStats);
+	RAIN__ADD_ICALL_(Profiler_GetTypeStats);
+	RAIN__ADD_ICALL_(Profiler_ResetTypeStats);
+
 	RAIN__ADD_ICALL_(ImGUI_Init);
 	RAIN__ADD_ICALL_(ImGUI_DeInit);
 	RAIN__ADD_ICALL_(ImGUI_BeginRender);
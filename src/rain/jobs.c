@@ -0,0 +1,241 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <threads.h>
+#include <unistd.h>
+#include <rain/jobs.h>
+
+struct rain__job_ {
+	rain_job_fn fn;
+	void *data;
+	size_t begin, end;
+	struct rain_jobs_counter *counter;
+	struct rain_jobs_counter *after;
+};
+
+// Chase-Lev deque: the owner pushes and takes at the bottom,
+// everybody else steals from the top.
+struct rain__jobs_deque_ {
+	_Alignas(64) _Atomic int64_t top;
+	_Alignas(64) _Atomic int64_t bottom;
+	struct rain__job_ jobs[RAIN_JOBS_DEQUE_SIZE];
+};
+
+static struct {
+	int worker_count;
+	thrd_t workers[RAIN_JOBS_MAX_WORKERS];
+	/** [0] belongs to the main thread, [i + 1] to worker i. */
+	struct rain__jobs_deque_ *deques;
+	atomic_bool quit;
+
+	/** jobs sitting in any deque, workers sleep while it's zero. */
+	atomic_size_t queued;
+	atomic_int sleeping;
+	mtx_t lock;
+	cnd_t wake;
+} jobs_;
+
+/** deque index of the current thread, -1 if it isn't ours. */
+static thread_local int rain__jobs_self_ = -1;
+
+static bool rain__jobs_push_(struct rain__jobs_deque_ *d, const struct rain__job_ *job) {
+	int64_t b = atomic_load_explicit(&d->bottom, memory_order_relaxed);
+	int64_t t = atomic_load_explicit(&d->top, memory_order_acquire);
+	if (b - t >= RAIN_JOBS_DEQUE_SIZE) return false;
+	d->jobs[b & (RAIN_JOBS_DEQUE_SIZE - 1)] = *job;
+	atomic_thread_fence(memory_order_release);
+	atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+	return true;
+}
+
+static bool rain__jobs_take_(struct rain__jobs_deque_ *d, struct rain__job_ *out) {
+	int64_t b = atomic_load_explicit(&d->bottom, memory_order_relaxed) - 1;
+	atomic_store_explicit(&d->bottom, b, memory_order_relaxed);
+	atomic_thread_fence(memory_order_seq_cst);
+	int64_t t = atomic_load_explicit(&d->top, memory_order_relaxed);
+	if (t > b) {
+		atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+		return false;
+	}
+	*out = d->jobs[b & (RAIN_JOBS_DEQUE_SIZE - 1)];
+	if (t == b) {
+		// last one, race the thieves for it.
+		bool won = atomic_compare_exchange_strong_explicit(&d->top, &t, t + 1,
+			memory_order_seq_cst, memory_order_relaxed);
+		atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+		return won;
+	}
+	return true;
+}
+
+static bool rain__jobs_steal_(struct rain__jobs_deque_ *d, struct rain__job_ *out) {
+	int64_t t = atomic_load_explicit(&d->top, memory_order_acquire);
+	atomic_thread_fence(memory_order_seq_cst);
+	int64_t b = atomic_load_explicit(&d->bottom, memory_order_acquire);
+	if (t >= b) return false;
+	*out = d->jobs[t & (RAIN_JOBS_DEQUE_SIZE - 1)];
+	return atomic_compare_exchange_strong_explicit(&d->top, &t, t + 1,
+		memory_order_seq_cst, memory_order_relaxed);
+}
+
+static void rain__jobs_notify_() {
+	atomic_fetch_add(&jobs_.queued, 1);
+	if (atomic_load(&jobs_.sleeping) > 0) {
+		mtx_lock(&jobs_.lock);
+		cnd_signal(&jobs_.wake);
+		mtx_unlock(&jobs_.lock);
+	}
+}
+
+static void rain__jobs_execute_(const struct rain__job_ *job) {
+	job->fn(job->data, job->begin, job->end);
+	if (job->counter) {
+		atomic_fetch_sub_explicit(&job->counter->pending, 1, memory_order_acq_rel);
+	}
+}
+
+static void rain__jobs_schedule_(const struct rain__job_ *job) {
+	if (rain__jobs_push_(&jobs_.deques[rain__jobs_self_], job)) {
+		rain__jobs_notify_();
+		return;
+	}
+	// full, do it now. the dependency still has to finish first.
+	if (job->after) rain_jobs_wait(job->after);
+	rain__jobs_execute_(job);
+}
+
+/** newest job of our own deque first, then steal starting after ourselves.
+    `oldest` steals from our own deque too, to get under blocked jobs. */
+static bool rain__jobs_find_(struct rain__job_ *out, bool oldest) {
+	int self = rain__jobs_self_;
+	int count = jobs_.worker_count + 1;
+	bool found = !oldest && rain__jobs_take_(&jobs_.deques[self], out);
+	for (int i = oldest ? 0 : 1; !found && i < count; ++i) {
+		found = rain__jobs_steal_(&jobs_.deques[(self + i) % count], out);
+	}
+	if (found) atomic_fetch_sub(&jobs_.queued, 1);
+	return found;
+}
+
+/** runs one job if there is one that's ready. */
+static bool rain__jobs_run_one_() {
+	struct rain__job_ job;
+	if (!rain__jobs_find_(&job, false)) return false;
+	if (job.after && !rain_jobs_done(job.after)) {
+		// not ready, put it back. what it waits for was likely
+		// scheduled before it, so look at the oldest jobs instead.
+		rain__jobs_schedule_(&job);
+		if (!rain__jobs_find_(&job, true)) return false;
+		if (job.after && !rain_jobs_done(job.after)) {
+			rain__jobs_schedule_(&job);
+			return false;
+		}
+	}
+	rain__jobs_execute_(&job);
+	return true;
+}
+
+static int rain__jobs_worker_(void *arg) {
+	rain__jobs_self_ = (int)(intptr_t)arg;
+	while (!atomic_load(&jobs_.quit)) {
+		if (rain__jobs_run_one_()) continue;
+		if (atomic_load(&jobs_.queued) != 0) {
+			// only blocked jobs left.
+			thrd_yield();
+			continue;
+		}
+		mtx_lock(&jobs_.lock);
+		atomic_fetch_add(&jobs_.sleeping, 1);
+		while (!atomic_load(&jobs_.quit) && atomic_load(&jobs_.queued) == 0) {
+			cnd_wait(&jobs_.wake, &jobs_.lock);
+		}
+		atomic_fetch_sub(&jobs_.sleeping, 1);
+		mtx_unlock(&jobs_.lock);
+	}
+	return 0;
+}
+
+void rain_jobs_init(int worker_count) {
+	if (worker_count <= 0) worker_count = (int)sysconf(_SC_NPROCESSORS_ONLN) - 1;
+	const char *env = getenv("RAIN_JOBS_WORKERS");
+	if (env != nullptr && *env != '\0') worker_count = atoi(env);
+	if (worker_count < 0) worker_count = 0;
+	if (worker_count > RAIN_JOBS_MAX_WORKERS) worker_count = RAIN_JOBS_MAX_WORKERS;
+
+	jobs_.worker_count = worker_count;
+	atomic_store(&jobs_.quit, false);
+	jobs_.deques = calloc(worker_count + 1, sizeof(struct rain__jobs_deque_));
+	mtx_init(&jobs_.lock, mtx_plain);
+	cnd_init(&jobs_.wake);
+	rain__jobs_self_ = 0;
+	for (int i = 0; i < worker_count; ++i) {
+		if (thrd_create(&jobs_.workers[i], &rain__jobs_worker_, (void*)(intptr_t)(i + 1)) != thrd_success) {
+			fprintf(stderr, "jobs/ERR failed to start worker %d\n", i);
+			jobs_.worker_count = i;
+			break;
+		}
+	}
+	fprintf(stderr, "jobs/INFO %d workers\n", jobs_.worker_count);
+}
+
+void rain_jobs_deinit() {
+	// whatever is still queued runs here, nobody will wait for it otherwise.
+	while (rain__jobs_run_one_() || atomic_load(&jobs_.queued) != 0) { }
+
+	mtx_lock(&jobs_.lock);
+	atomic_store(&jobs_.quit, true);
+	cnd_broadcast(&jobs_.wake);
+	mtx_unlock(&jobs_.lock);
+	for (int i = 0; i < jobs_.worker_count; ++i) thrd_join(jobs_.workers[i], nullptr);
+
+	cnd_destroy(&jobs_.wake);
+	mtx_destroy(&jobs_.lock);
+	free(jobs_.deques);
+	jobs_.deques = nullptr;
+}
+
+int rain_jobs_worker_count() {
+	return jobs_.worker_count;
+}
+
+void rain_jobs_parallel_for(
+	rain_job_fn fn,
+	void *data,
+	size_t count,
+	size_t batch,
+	struct rain_jobs_counter *counter,
+	struct rain_jobs_counter *after
+) {
+	if (count == 0) return;
+	if (batch == 0) {
+		// a few jobs per thread so stealing can even things out.
+		size_t jobs = (size_t)(jobs_.worker_count + 1) * 4;
+		batch = (count + jobs - 1) / jobs;
+	}
+	if (rain__jobs_self_ < 0) {
+		fprintf(stderr, "jobs/ERR scheduled from a foreign thread, running inline.\n");
+		if (after) while (!rain_jobs_done(after)) thrd_yield();
+		fn(data, 0, count);
+		return;
+	}
+
+	size_t job_count = (count + batch - 1) / batch;
+	if (counter) atomic_fetch_add_explicit(&counter->pending, job_count, memory_order_relaxed);
+	for (size_t begin = 0; begin < count; begin += batch) {
+		struct rain__job_ job = {
+			.fn = fn,
+			.data = data,
+			.begin = begin,
+			.end = begin + batch < count ? begin + batch : count,
+			.counter = counter,
+			.after = after,
+		};
+		rain__jobs_schedule_(&job);
+	}
+}
+
+void rain_jobs_wait(struct rain_jobs_counter *counter) {
+	while (!rain_jobs_done(counter)) {
+		if (rain__jobs_self_ < 0 || !rain__jobs_run_one_()) thrd_yield();
+	}
+}
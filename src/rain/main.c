@@ -2,23 +2,91 @@
 #include <rain/camera.h>
 #include <rain/transform.h>
 #include <rain/renderer.h>
+#include <rain/jobs.h>
 
 #include <mono/jit/jit.h>
 #include <mono/metadata/assembly.h>
-#include <mono/metadata/debug-helpers.h>
 #include <mono/metadata/mono-config.h>
 
+#include <time.h>
+#include <string.h>
+#include <stdlib.h>
+
 #include "engine.h"
 #include "interop.h"
+#include "script.h"
+#include "profiler.h"
+#include "render_thread.h"
 
 struct rain_engine rain__engine_;
 
+/** simulation rate, `rain_script_fixed_update` runs this often. */
+#define RAIN__FIXED_STEP_NS_ (UINT64_C(1000000000) / 60)
+#define RAIN__FIXED_DELTA_TIME_ (RAIN__FIXED_STEP_NS_ / 1e9f)
+/** fixed steps per frame at most. after a longer spike the backlog
+    is dropped instead of making the next frame even slower. */
+#define RAIN__MAX_FIXED_STEPS_ 5
+/** frames to keep running after the last event, imgui needs a few to settle. */
+#define RAIN__IDLE_AFTER_FRAMES_ 3
+/** redraw at least this often (seconds) while idle. */
+#define RAIN__IDLE_TIMEOUT_ 0.5
+
+/** how the managed side gets its native code, set by `RAIN_EXEC_MODE`. */
+enum rain__exec_mode_ {
+	/** use AOT images (`csrain.dll.so`, ...) if they exist, JIT the rest. */
+	RAIN__EXEC_MODE_AOT_,
+	/** ignore AOT images and JIT everything. */
+	RAIN__EXEC_MODE_JIT_,
+};
+
+static const char *rain__exec_mode_names_[] = { "aot", "jit" };
+
+static enum rain__exec_mode_ rain__get_exec_mode_() {
+	const char *mode = getenv("RAIN_EXEC_MODE");
+	if (mode == nullptr) return RAIN__EXEC_MODE_AOT_;
+	for (int i = 0; i < 2; ++i) {
+		if (strcmp(mode, rain__exec_mode_names_[i]) == 0) return i;
+	}
+	fprintf(stderr, "rain/WARN unknown RAIN_EXEC_MODE '%s', using 'aot'.\n", mode);
+	return RAIN__EXEC_MODE_AOT_;
+}
+
+static void rain__set_exec_mode_(enum rain__exec_mode_ mode) {
+	switch (mode) {
+	case RAIN__EXEC_MODE_AOT_: break; // mono's default.
+	case RAIN__EXEC_MODE_JIT_:
+		// same as `mono -O=-aot`, skips loading the AOT images.
+		mono_jit_parse_options(1, (char*[]){ "-O=-aot" });
+		break;
+	}
+}
+
+/** wall time in milliseconds, for the startup/frame time report. */
+static double rain__bench_now_ms_() {
+	struct timespec ts;
+	timespec_get(&ts, TIME_UTC);
+	return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
 
 int main() {
+	double bench_start = rain__bench_now_ms_();
+	enum rain__exec_mode_ exec_mode = rain__get_exec_mode_();
+	// stop after this many frames, used by `ninja bench`. 0 means never.
+	const char *bench_frames_env = getenv("RAIN_BENCH_FRAMES");
+	long bench_frames = bench_frames_env ? strtol(bench_frames_env, nullptr, 10) : 0;
+
+	rain_jobs_init(0);
 	rain_window_init(&rain__engine_.window, "Mokosh (Engine)", 1920/1.5, 1080/1.5);
 	rain_renderer_init(&rain__engine_.renderer, &rain__engine_.window);
+	rain_render_thread_init(&rain__engine_.window);
+	rain_assets_init(&rain__engine_.assets);
+	rain_thumbnails_init(&rain__engine_.thumbnails);
+	rain_texture_streaming_init(&rain__engine_.texture_streaming);
+	rain_texture_uploads_init(&rain__engine_.texture_uploads, &rain__engine_.renderer);
 
 	mono_config_parse(nullptr);
+	rain__set_exec_mode_(exec_mode);
+	rain_profiler_init();
 
 	MonoDomain *domain = mono_jit_init("RainEngine_Domain");
 
@@ -42,50 +110,99 @@ int main() {
 		return 1;
 	}
 	
-	MonoMethodDesc *script_entry_method_desc = mono_method_desc_new("RainEngine.Main:Entry()", true);
-	MonoMethod *script_entry_method = mono_method_desc_search_in_image(script_entry_method_desc, image);
-	if (script_entry_method) {
-		mono_runtime_invoke(script_entry_method, nullptr, (void*[0]){}, nullptr);
-	}
-	
-	MonoMethodDesc *script_render_method_desc = mono_method_desc_new("RainEngine.Main:Render()", true);
-	MonoMethod *script_render_method = mono_method_desc_search_in_image(script_render_method_desc, image);
-	
-	MonoMethodDesc *script_update_method_desc = mono_method_desc_new("RainEngine.Main:Update", true);
-	MonoMethod *script_update_method = mono_method_desc_search_in_image(script_update_method_desc, image);
+	rain_script_bind(image);
+	rain_script_entry();
 
-	MonoMethodDesc *script_destroy_method_desc = mono_method_desc_new("RainEngine.Main:Destroy()", true);
-	MonoMethod *script_destroy_method = mono_method_desc_search_in_image(script_destroy_method_desc, image);
-	
-	float lastTime = rain_window_get_time(&rain__engine_.window);
-	while (!rain_window_should_close(&rain__engine_.window)) {
-		float currentTime = rain_window_get_time(&rain__engine_.window);
-		rain__engine_.delta_time = currentTime - lastTime;
-
-		if (script_update_method) {
-			mono_runtime_invoke(script_update_method, nullptr,
-				(void*[1]){&(float){rain__engine_.delta_time}}, nullptr);
+	int fb_width, fb_height;
+	rain_window_get_fb_size(&rain__engine_.window, &fb_width, &fb_height);
+	uint64_t fixed_accumulator_ns = 0;
+
+	double bench_startup = rain__bench_now_ms_() - bench_start;
+	double bench_first_frame = 0.0, bench_frame_total = 0.0, bench_frame_max = 0.0;
+	long bench_frame_count = 0;
+
+	int busy_frames = RAIN__IDLE_AFTER_FRAMES_;
+
+	uint64_t last_time_ns = rain_window_get_time_ns(&rain__engine_.window);
+	while (!rain_window_should_close(&rain__engine_.window) && !rain_script_failed()) {
+		if (rain_window_take_events(&rain__engine_.window)) busy_frames = RAIN__IDLE_AFTER_FRAMES_;
+		else if (busy_frames > 0) --busy_frames;
+
+		// benchmarks measure the loop, never idle there.
+		bool idle = rain__engine_.allow_idle && busy_frames == 0 && bench_frames == 0;
+		if (idle) rain_window_wait(&rain__engine_.window, RAIN__IDLE_TIMEOUT_);
+
+		double bench_frame_start = rain__bench_now_ms_();
+		uint64_t time_ns = rain_window_get_time_ns(&rain__engine_.window);
+		uint64_t frame_ns = time_ns - last_time_ns;
+		last_time_ns = time_ns;
+		rain__engine_.delta_time = frame_ns / 1e9f;
+
+		int new_fb_width, new_fb_height;
+		rain_window_get_fb_size(&rain__engine_.window, &new_fb_width, &new_fb_height);
+		if (new_fb_width != fb_width || new_fb_height != fb_height) {
+			fb_width = new_fb_width;
+			fb_height = new_fb_height;
+			rain_script_resize(fb_width, fb_height);
+		}
+
+		// time spent waiting isn't simulated.
+		if (!idle) fixed_accumulator_ns += frame_ns;
+		for (int step = 0; step < RAIN__MAX_FIXED_STEPS_
+				&& fixed_accumulator_ns >= RAIN__FIXED_STEP_NS_; ++step) {
+			rain_script_fixed_update(RAIN__FIXED_DELTA_TIME_);
+			fixed_accumulator_ns -= RAIN__FIXED_STEP_NS_;
 		}
+		// keep the phase, drop whole steps.
+		fixed_accumulator_ns %= RAIN__FIXED_STEP_NS_;
+		float fixed_alpha = (float)fixed_accumulator_ns / RAIN__FIXED_STEP_NS_;
+
+		rain_script_update(rain__engine_.delta_time);
+		rain_script_late_update(rain__engine_.delta_time);
 		
+		rain_thumbnails_update(&rain__engine_.thumbnails);
+		// what was drawn last frame decides what to load.
+		rain_texture_streaming_update(&rain__engine_.texture_streaming);
 		rain_renderer_begin_render(&rain__engine_.renderer);
-		if (script_render_method) {
-			mono_runtime_invoke(script_render_method, nullptr,
-				(void*[0]){}, nullptr);
-		}
+		// updates made while rendering wait for the next frame.
+		rain_texture_uploads_flush(&rain__engine_.texture_uploads);
+		rain_script_render(fixed_alpha);
 		rain_renderer_end_render(&rain__engine_.renderer);
 	
-		rain_window_frame(&rain__engine_.window);
-		
-		lastTime = currentTime;
-	}
+		// runs while the next frame is updated and recorded.
+		rain_render_thread_submit();
+		rain_window_poll(&rain__engine_.window);
+		rain_profiler_frame();
 
-	if (script_destroy_method) {
-		mono_runtime_invoke(script_destroy_method, nullptr, (void*[0]){}, nullptr);
+		// the first frame is mostly JIT/AOT-load time, keep it out of the average.
+		double bench_frame = rain__bench_now_ms_() - bench_frame_start;
+		if (bench_frame_count++ == 0) bench_first_frame = bench_frame;
+		else {
+			bench_frame_total += bench_frame;
+			if (bench_frame > bench_frame_max) bench_frame_max = bench_frame;
+		}
+		if (bench_frames != 0 && bench_frame_count >= bench_frames) break;
 	}
 
+	fprintf(stderr, "bench/INFO mode=%s startup=%.2fms first_frame=%.2fms"
+		" frames=%ld frame_avg=%.3fms frame_max=%.3fms\n",
+		rain__exec_mode_names_[exec_mode], bench_startup, bench_first_frame,
+		bench_frame_count,
+		bench_frame_count > 1 ? bench_frame_total / (bench_frame_count - 1) : 0.0,
+		bench_frame_max);
+
+	rain_script_destroy();
+
 	mono_jit_cleanup(domain);
 	domain = nullptr;
 
+	// everything below touches sokol directly again.
+	rain_render_thread_deinit();
+	rain_thumbnails_deinit(&rain__engine_.thumbnails);
+	rain_texture_streaming_deinit(&rain__engine_.texture_streaming);
+	rain_texture_uploads_deinit(&rain__engine_.texture_uploads);
+	rain_assets_deinit(&rain__engine_.assets);
 	rain_renderer_deinit(&rain__engine_.renderer);
 	rain_window_deinit(&rain__engine_.window);
+	rain_jobs_deinit();
 }
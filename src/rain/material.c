@@ -0,0 +1,329 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <rain/material.h>
+#include "render_thread.h"
+
+/** everything but the shader source that goes into a pipeline. */
+struct rain__pipeline_key_ {
+	uint32_t shader;
+	uint32_t blend;
+	bool depth_test;
+	bool depth_write;
+};
+
+struct rain__pipeline_entry_ {
+	struct rain__pipeline_key_ key;
+	/** SG_INVALID_ID marks an empty slot. */
+	sg_pipeline pipeline;
+};
+
+// the cache is only touched on the render thread.
+static struct {
+	/** open addressing, the capacity is a power of two. */
+	struct rain__pipeline_entry_ *entries;
+	size_t count, capacity;
+	/** every shader made, destroyed at deinit. */
+	sg_shader *shaders;
+	size_t shader_count, shader_capacity;
+	/** main thread. */
+	uint32_t next_id;
+} materials_;
+
+static const char *rain__material_vs_source_ =
+	"#version 330\n"
+	"layout(location = 0) in vec2 i_position;\n"
+	"uniform mat4 u_trans;\n"
+	"uniform vec4 u_uvs;\n"
+	"out vec2 s_uv;\n"
+	"void main() {\n"
+	"  vec2[] texcoords = vec2[](\n"
+	"    u_uvs.xy, vec2(u_uvs.z, u_uvs.y),\n"
+	"    vec2(u_uvs.x, u_uvs.w), u_uvs.zw \n"
+	"  );\n"
+	"  gl_Position = vec4(i_position, 0.0, 1.0) * u_trans;\n"
+	"  s_uv = texcoords[gl_VertexID];\n"
+	"}\n";
+
+static size_t rain__pipeline_hash_(const struct rain__pipeline_key_ *key) {
+	uint64_t h = (uint64_t)key->shader << 32
+		| key->blend << 2 | key->depth_test << 1 | key->depth_write;
+	// splitmix64 finalizer
+	h ^= h >> 30; h *= UINT64_C(0xbf58476d1ce4e5b9);
+	h ^= h >> 27; h *= UINT64_C(0x94d049bb133111eb);
+	h ^= h >> 31;
+	return (size_t)h;
+}
+
+static bool rain__pipeline_key_eq_(const struct rain__pipeline_key_ *a, const struct rain__pipeline_key_ *b) {
+	return a->shader == b->shader && a->blend == b->blend
+		&& a->depth_test == b->depth_test && a->depth_write == b->depth_write;
+}
+
+static struct rain__pipeline_entry_ *rain__pipeline_slot_(
+	struct rain__pipeline_entry_ *entries,
+	size_t capacity,
+	const struct rain__pipeline_key_ *key
+) {
+	size_t mask = capacity - 1;
+	for (size_t i = rain__pipeline_hash_(key) & mask;; i = (i + 1) & mask) {
+		if (entries[i].pipeline.id == SG_INVALID_ID) return &entries[i];
+		if (rain__pipeline_key_eq_(&entries[i].key, key)) return &entries[i];
+	}
+}
+
+static sg_blend_state rain__blend_state_(enum rain_blend_mode mode) {
+	switch (mode) {
+	case RAIN_BLEND_ALPHA: return (sg_blend_state){
+		.enabled = true,
+		.src_factor_rgb = SG_BLENDFACTOR_SRC_ALPHA,
+		.dst_factor_rgb = SG_BLENDFACTOR_ONE_MINUS_SRC_ALPHA,
+		.op_rgb = SG_BLENDOP_ADD,
+		.src_factor_alpha = SG_BLENDFACTOR_ZERO,
+		.dst_factor_alpha = SG_BLENDFACTOR_ONE,
+		.op_alpha = SG_BLENDOP_ADD,
+	};
+	case RAIN_BLEND_ADDITIVE: return (sg_blend_state){
+		.enabled = true,
+		.src_factor_rgb = SG_BLENDFACTOR_SRC_ALPHA,
+		.dst_factor_rgb = SG_BLENDFACTOR_ONE,
+		.src_factor_alpha = SG_BLENDFACTOR_ZERO,
+		.dst_factor_alpha = SG_BLENDFACTOR_ONE,
+	};
+	case RAIN_BLEND_PREMULTIPLIED: return (sg_blend_state){
+		.enabled = true,
+		.src_factor_rgb = SG_BLENDFACTOR_ONE,
+		.dst_factor_rgb = SG_BLENDFACTOR_ONE_MINUS_SRC_ALPHA,
+		.src_factor_alpha = SG_BLENDFACTOR_ZERO,
+		.dst_factor_alpha = SG_BLENDFACTOR_ONE,
+	};
+	case RAIN_BLEND_OPAQUE:
+	default: return (sg_blend_state){ .enabled = false };
+	}
+}
+
+static sg_pipeline rain__make_pipeline_(const struct rain__pipeline_key_ *key) {
+	return sg_make_pipeline(&(sg_pipeline_desc){
+		.label = "Material Pipeline",
+		.layout.attrs[0].format = SG_VERTEXFORMAT_FLOAT2,
+		.shader = (sg_shader){ key->shader },
+		.index_type = SG_INDEXTYPE_NONE,
+		.cull_mode = SG_CULLMODE_NONE,
+		.primitive_type = SG_PRIMITIVETYPE_TRIANGLE_STRIP,
+		.depth = {
+			.pixel_format = SG_PIXELFORMAT_DEPTH_STENCIL,
+			.compare = key->depth_test ? SG_COMPAREFUNC_LESS_EQUAL : SG_COMPAREFUNC_ALWAYS,
+			.write_enabled = key->depth_write,
+		},
+		.colors[0].blend = rain__blend_state_(key->blend),
+	});
+}
+
+/** the cached pipeline for `key`, made on first use. */
+static sg_pipeline rain__pipeline_get_(const struct rain__pipeline_key_ *key) {
+	if (materials_.capacity != 0) {
+		struct rain__pipeline_entry_ *slot = rain__pipeline_slot_(
+			materials_.entries, materials_.capacity, key);
+		if (slot->pipeline.id != SG_INVALID_ID) return slot->pipeline;
+	}
+
+	// keep the load under a half.
+	if ((materials_.count + 1) * 2 > materials_.capacity) {
+		size_t capacity = materials_.capacity ? materials_.capacity * 2 : 32;
+		struct rain__pipeline_entry_ *entries = calloc(capacity, sizeof(*entries));
+		for (size_t i = 0; i < materials_.capacity; ++i) {
+			struct rain__pipeline_entry_ *old = &materials_.entries[i];
+			if (old->pipeline.id == SG_INVALID_ID) continue;
+			*rain__pipeline_slot_(entries, capacity, &old->key) = *old;
+		}
+		free(materials_.entries);
+		materials_.entries = entries;
+		materials_.capacity = capacity;
+	}
+
+	struct rain__pipeline_entry_ *slot = rain__pipeline_slot_(
+		materials_.entries, materials_.capacity, key);
+	slot->key = *key;
+	slot->pipeline = rain__make_pipeline_(key);
+	materials_.count += 1;
+	return slot->pipeline;
+}
+
+struct rain__shader_make_ {
+	const sg_shader_desc *desc;
+	sg_shader shader;
+};
+
+static void rain__shader_make_(void *arg) {
+	struct rain__shader_make_ *make = arg;
+	make->shader = sg_make_shader(make->desc);
+	if (materials_.shader_count == materials_.shader_capacity) {
+		materials_.shader_capacity = materials_.shader_capacity ? materials_.shader_capacity * 2 : 16;
+		materials_.shaders = realloc(materials_.shaders,
+			materials_.shader_capacity * sizeof(sg_shader));
+	}
+	materials_.shaders[materials_.shader_count++] = make->shader;
+}
+
+void rain_shader_init(
+	struct rain_shader *restrict this,
+	const char *label,
+	const char *fs_body,
+	uint32_t param_count,
+	bool textured
+) {
+	if (param_count > RAIN_MATERIAL_MAX_PARAMS) {
+		fprintf(stderr, "material/ERR shader '%s' has %u params, at most %d are supported.\n",
+			label, param_count, RAIN_MATERIAL_MAX_PARAMS);
+		param_count = RAIN_MATERIAL_MAX_PARAMS;
+	}
+	this->param_count = param_count;
+	this->textured = textured;
+
+	char header[256];
+	int header_length = snprintf(header, sizeof(header),
+		"#version 330\n"
+		"in vec2 s_uv;\n"
+		"out vec4 o_color;\n"
+		"uniform vec4 u_tint;\n"
+		"%s%s",
+		textured ? "uniform sampler2D u_texture;\n" : "",
+		param_count ? "uniform vec4 u_params[" : "");
+	if (param_count) {
+		header_length += snprintf(header + header_length, sizeof(header) - header_length,
+			"%u];\n", param_count);
+	}
+	size_t body_length = strlen(fs_body);
+	char *fs_source = malloc(header_length + body_length + 1);
+	memcpy(fs_source, header, header_length);
+	memcpy(fs_source + header_length, fs_body, body_length + 1);
+
+	sg_shader_desc desc = {
+		.label = label,
+		.vs = {
+			.uniform_blocks[0] = {
+				.size = sizeof(rain_float4x4) + sizeof(rain_float4),
+				.uniforms = {
+					[0] = { .name = "u_trans", .type = SG_UNIFORMTYPE_MAT4 },
+					[1] = { .name = "u_uvs", .type = SG_UNIFORMTYPE_FLOAT4 },
+				},
+			},
+			.source = rain__material_vs_source_,
+		},
+		.fs = {
+			// [0] changes every draw, [1] only with the material.
+			.uniform_blocks[0] = {
+				.size = sizeof(rain_float4),
+				.uniforms[0] = { .name = "u_tint", .type = SG_UNIFORMTYPE_FLOAT4 },
+			},
+			.source = fs_source,
+		},
+	};
+	if (param_count) {
+		desc.fs.uniform_blocks[1] = (sg_shader_uniform_block_desc){
+			.size = param_count * sizeof(rain_float4),
+			.uniforms[0] = {
+				.name = "u_params",
+				.type = SG_UNIFORMTYPE_FLOAT4,
+				.array_count = (int)param_count,
+			},
+		};
+	}
+	if (textured) {
+		desc.fs.images[0].used = true;
+		desc.fs.samplers[0].used = true;
+		desc.fs.image_sampler_pairs[0] = (sg_shader_image_sampler_pair_desc){
+			.used = true,
+			.glsl_name = "u_texture",
+			.image_slot = 0,
+			.sampler_slot = 0,
+		};
+	}
+
+	struct rain__shader_make_ make = { .desc = &desc };
+	rain_render_thread_sync(&rain__shader_make_, &make);
+	this->shader = make.shader;
+	free(fs_source);
+}
+
+struct rain__material_make_ {
+	struct rain__pipeline_key_ key;
+	sg_pipeline pipeline;
+};
+
+static void rain__material_make_(void *arg) {
+	struct rain__material_make_ *make = arg;
+	make->pipeline = rain__pipeline_get_(&make->key);
+}
+
+void rain_material_init(
+	struct rain_material *restrict this,
+	const struct rain_shader *restrict shader,
+	struct rain_material_state state
+) {
+	*this = (struct rain_material){
+		.shader = shader,
+		.state = state,
+		.id = ++materials_.next_id,
+	};
+	struct rain__material_make_ make = {
+		.key = {
+			.shader = shader->shader.id,
+			.blend = state.blend,
+			.depth_test = state.depth_test,
+			.depth_write = state.depth_write,
+		},
+	};
+	rain_render_thread_sync(&rain__material_make_, &make);
+	this->pipeline = make.pipeline;
+}
+
+struct rain__material_params_cmd_ {
+	struct rain_material *material;
+	uint32_t first, count;
+	rain_float4 values[RAIN_MATERIAL_MAX_PARAMS];
+};
+
+static void rain__material_params_(void *payload) {
+	struct rain__material_params_cmd_ *cmd = payload;
+	memcpy(&cmd->material->render_params_[cmd->first], cmd->values,
+		cmd->count * sizeof(rain_float4));
+	cmd->material->render_version_ += 1;
+}
+
+void rain_material_set_params(
+	struct rain_material *restrict this,
+	uint32_t first,
+	uint32_t count,
+	const rain_float4 *restrict values
+) {
+	if (first >= RAIN_MATERIAL_MAX_PARAMS) return;
+	if (count > RAIN_MATERIAL_MAX_PARAMS - first) count = RAIN_MATERIAL_MAX_PARAMS - first;
+	memcpy(&this->params[first], values, count * sizeof(rain_float4));
+
+	struct rain__material_params_cmd_ cmd = {
+		.material = this,
+		.first = first,
+		.count = count,
+	};
+	memcpy(cmd.values, values, count * sizeof(rain_float4));
+	rain_render_thread_call(&rain__material_params_, &cmd, sizeof(cmd));
+}
+
+void rain_material_destroy_and_free(struct rain_material *this) {
+	rain_render_thread_free(this);
+}
+
+void rain_materials_deinit() {
+	for (size_t i = 0; i < materials_.capacity; ++i) {
+		if (materials_.entries[i].pipeline.id != SG_INVALID_ID) {
+			sg_destroy_pipeline(materials_.entries[i].pipeline);
+		}
+	}
+	for (size_t i = 0; i < materials_.shader_count; ++i) {
+		sg_destroy_shader(materials_.shaders[i]);
+	}
+	free(materials_.entries);
+	free(materials_.shaders);
+	memset(&materials_, 0, sizeof(materials_));
+}
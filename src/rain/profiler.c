@@ -0,0 +1,167 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <mono/metadata/profiler.h>
+#include "profiler.h"
+
+struct rain__profiler_type_ {
+	MonoClass *_Atomic klass;
+	atomic_uint_fast64_t samples;
+	atomic_uint_fast64_t bytes;
+};
+
+// allocations and GCs can happen on any managed thread, so the
+// counters are atomics and frames are swapped out by the main thread.
+struct _MonoProfiler {
+	enum rain_profiler_mode mode;
+	MonoProfilerHandle handle;
+
+	atomic_uint_fast64_t alloc_count;
+	atomic_uint_fast64_t alloc_bytes;
+	atomic_uint gc_count;
+	atomic_uint gc_major_count;
+	// only touched from the GC callback, the world is stopped around it.
+	uint64_t gc_pause_start_ns;
+	// the main thread swaps these out while the GC may be adding to them.
+	atomic_uint_fast64_t gc_pause_ns;
+	atomic_uint_fast64_t gc_max_pause_ns;
+
+	atomic_uint_fast64_t sample_counter;
+	struct rain__profiler_type_ types[RAIN_PROFILER_MAX_TYPES];
+
+	struct rain_profiler_frame_stats last_frame;
+};
+
+static struct _MonoProfiler profiler_;
+
+static uint64_t rain__profiler_now_ns_() {
+	struct timespec ts;
+	timespec_get(&ts, TIME_UTC);
+	return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static void rain__profiler_sample_(MonoProfiler *prof, MonoClass *klass, unsigned size) {
+	// open addressing on the class pointer, slots are claimed once and never freed.
+	size_t hash = ((uintptr_t)klass >> 4) * 0x9E3779B97F4A7C15ull;
+	for (size_t i = 0; i < RAIN_PROFILER_MAX_TYPES; ++i) {
+		struct rain__profiler_type_ *t =
+			&prof->types[(hash + i) % RAIN_PROFILER_MAX_TYPES];
+		MonoClass *expected = nullptr;
+		if (atomic_load_explicit(&t->klass, memory_order_acquire) == klass
+			|| atomic_compare_exchange_strong(&t->klass, &expected, klass)
+			|| expected == klass) {
+			atomic_fetch_add_explicit(&t->samples, 1, memory_order_relaxed);
+			atomic_fetch_add_explicit(&t->bytes, size, memory_order_relaxed);
+			return;
+		}
+	}
+	// table full, drop the sample.
+}
+
+static void rain__profiler_on_alloc_(MonoProfiler *prof, MonoObject *object) {
+	unsigned size = mono_object_get_size(object);
+	atomic_fetch_add_explicit(&prof->alloc_count, 1, memory_order_relaxed);
+	atomic_fetch_add_explicit(&prof->alloc_bytes, size, memory_order_relaxed);
+	if (prof->mode == RAIN_PROFILER_MODE_SAMPLED
+		&& atomic_fetch_add_explicit(&prof->sample_counter, 1, memory_order_relaxed)
+			% RAIN_PROFILER_SAMPLE_INTERVAL == 0) {
+		rain__profiler_sample_(prof, mono_object_get_class(object), size);
+	}
+}
+
+static void rain__profiler_on_gc_(
+	MonoProfiler *prof,
+	MonoProfilerGCEvent ev,
+	uint32_t generation,
+	[[maybe_unused]] mono_bool is_serial
+) {
+	switch (ev) {
+	case MONO_GC_EVENT_PRE_STOP_WORLD:
+		prof->gc_pause_start_ns = rain__profiler_now_ns_();
+		break;
+	case MONO_GC_EVENT_START:
+		atomic_fetch_add_explicit(&prof->gc_count, 1, memory_order_relaxed);
+		if (generation != 0) {
+			atomic_fetch_add_explicit(&prof->gc_major_count, 1, memory_order_relaxed);
+		}
+		break;
+	case MONO_GC_EVENT_POST_START_WORLD: {
+		uint64_t pause = rain__profiler_now_ns_() - prof->gc_pause_start_ns;
+		atomic_fetch_add_explicit(&prof->gc_pause_ns, pause, memory_order_relaxed);
+		uint_fast64_t max = atomic_load_explicit(&prof->gc_max_pause_ns, memory_order_relaxed);
+		while (pause > max && !atomic_compare_exchange_weak_explicit(&prof->gc_max_pause_ns,
+				&max, pause, memory_order_relaxed, memory_order_relaxed)) {}
+		break;
+	}
+	default: break;
+	}
+}
+
+void rain_profiler_init() {
+	const char *mode = getenv("RAIN_PROFILER");
+	profiler_.mode = RAIN_PROFILER_MODE_OFF;
+	if (mode != nullptr) {
+		if (strcmp(mode, "count") == 0) profiler_.mode = RAIN_PROFILER_MODE_COUNT;
+		else if (strcmp(mode, "sampled") == 0) profiler_.mode = RAIN_PROFILER_MODE_SAMPLED;
+		else if (strcmp(mode, "off") != 0) {
+			fprintf(stderr, "profiler/WARN unknown RAIN_PROFILER '%s', using 'off'.\n", mode);
+		}
+	}
+
+	profiler_.handle = mono_profiler_create(&profiler_);
+	mono_profiler_set_gc_event_callback(profiler_.handle, &rain__profiler_on_gc_);
+	if (profiler_.mode != RAIN_PROFILER_MODE_OFF) {
+		if (mono_profiler_enable_allocations()) {
+			mono_profiler_set_gc_allocation_callback(profiler_.handle, &rain__profiler_on_alloc_);
+		} else {
+			fprintf(stderr, "profiler/WARN allocation tracking not available.\n");
+			profiler_.mode = RAIN_PROFILER_MODE_OFF;
+		}
+	}
+}
+
+enum rain_profiler_mode rain_profiler_get_mode() {
+	return profiler_.mode;
+}
+
+void rain_profiler_frame() {
+	struct rain_profiler_frame_stats *f = &profiler_.last_frame;
+	f->alloc_count = atomic_exchange_explicit(&profiler_.alloc_count, 0, memory_order_relaxed);
+	f->alloc_bytes = atomic_exchange_explicit(&profiler_.alloc_bytes, 0, memory_order_relaxed);
+	f->gc_count = atomic_exchange_explicit(&profiler_.gc_count, 0, memory_order_relaxed);
+	f->gc_major_count = atomic_exchange_explicit(&profiler_.gc_major_count, 0, memory_order_relaxed);
+	// a GC running on another thread right now may land in either frame, that's fine.
+	f->gc_pause_ms = atomic_exchange_explicit(&profiler_.gc_pause_ns, 0, memory_order_relaxed) / 1e6;
+	f->gc_max_pause_ms = atomic_exchange_explicit(&profiler_.gc_max_pause_ns, 0, memory_order_relaxed) / 1e6;
+}
+
+void rain_profiler_get_frame_stats(struct rain_profiler_frame_stats *out_stats) {
+	*out_stats = profiler_.last_frame;
+}
+
+int rain_profiler_get_type_stats(struct rain_profiler_type_stats *out_types, int max) {
+	int n = 0;
+	for (size_t i = 0; i < RAIN_PROFILER_MAX_TYPES && n < max; ++i) {
+		struct rain__profiler_type_ *t = &profiler_.types[i];
+		MonoClass *klass = atomic_load_explicit(&t->klass, memory_order_acquire);
+		uint64_t samples = atomic_load_explicit(&t->samples, memory_order_relaxed);
+		if (klass == nullptr || samples == 0) continue;
+		out_types[n++] = (struct rain_profiler_type_stats){
+			.name_space = mono_class_get_namespace(klass),
+			.name = mono_class_get_name(klass),
+			.samples = samples,
+			.bytes = atomic_load_explicit(&t->bytes, memory_order_relaxed),
+		};
+	}
+	return n;
+}
+
+void rain_profiler_reset_type_stats() {
+	// keep the claimed classes, only clear their counts.
+	for (size_t i = 0; i < RAIN_PROFILER_MAX_TYPES; ++i) {
+		atomic_store_explicit(&profiler_.types[i].samples, 0, memory_order_relaxed);
+		atomic_store_explicit(&profiler_.types[i].bytes, 0, memory_order_relaxed);
+	}
+}
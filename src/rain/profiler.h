@@ -0,0 +1,57 @@
+#ifndef RAIN__PROFILER_H_
+#define RAIN__PROFILER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/** what the mono profiler tracks, set by `RAIN_PROFILER`. */
+enum rain_profiler_mode {
+	/** only GC pauses. (default) allocation callbacks keep mono from
+	    using its inline managed allocators. */
+	RAIN_PROFILER_MODE_OFF = 0,
+	/** GC pauses, allocation count and bytes. */
+	RAIN_PROFILER_MODE_COUNT = 1,
+	/** like count, plus every `RAIN_PROFILER_SAMPLE_INTERVAL`th
+	    allocation is attributed to its class. */
+	RAIN_PROFILER_MODE_SAMPLED = 2,
+};
+
+#define RAIN_PROFILER_SAMPLE_INTERVAL 16
+#define RAIN_PROFILER_MAX_TYPES 1024
+
+/** NB: layout shared with `RainEngine.Profiler.FrameStats`. */
+struct rain_profiler_frame_stats {
+	uint64_t alloc_count;
+	uint64_t alloc_bytes;
+	uint32_t gc_count;
+	uint32_t gc_major_count;
+	double gc_pause_ms;
+	double gc_max_pause_ms;
+};
+
+/** NB: layout shared with `RainNative.Interop.Profiler_TypeStats`.
+    counts are sampled, multiply by the interval for an estimate. */
+struct rain_profiler_type_stats {
+	const char *name_space;
+	const char *name;
+	uint64_t samples;
+	uint64_t bytes;
+};
+
+/** register the profiler. must be called before `mono_jit_init`. */
+void rain_profiler_init();
+
+enum rain_profiler_mode rain_profiler_get_mode();
+
+/** close the current frame, its stats become the ones returned by
+    `rain_profiler_get_frame_stats`. */
+void rain_profiler_frame();
+
+void rain_profiler_get_frame_stats(struct rain_profiler_frame_stats *out_stats);
+
+/** copy up to `max` sampled types into `out_types`, returns how many. */
+int rain_profiler_get_type_stats(struct rain_profiler_type_stats *out_types, int max);
+
+void rain_profiler_reset_type_stats();
+
+#endif // RAIN__PROFILER_H_
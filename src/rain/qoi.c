@@ -0,0 +1,223 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <rain/qoi.h>
+
+#define RAIN__QOI_OP_INDEX_ 0x00
+#define RAIN__QOI_OP_DIFF_ 0x40
+#define RAIN__QOI_OP_LUMA_ 0x80
+#define RAIN__QOI_OP_RUN_ 0xc0
+#define RAIN__QOI_OP_RGB_ 0xfe
+#define RAIN__QOI_OP_RGBA_ 0xff
+#define RAIN__QOI_MASK_ 0xc0
+#define RAIN__QOI_PADDING_SIZE_ 8
+
+static const uint8_t rain__qoi_padding_[RAIN__QOI_PADDING_SIZE_] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+
+union rain__qoi_px_ {
+	struct { uint8_t r, g, b, a; } rgba;
+	uint32_t v;
+};
+
+static inline int rain__qoi_hash_(union rain__qoi_px_ px) {
+	return (px.rgba.r * 3 + px.rgba.g * 5 + px.rgba.b * 7 + px.rgba.a * 11) % 64;
+}
+
+static inline uint32_t rain__qoi_read_u32_(const uint8_t *bytes) {
+	return (uint32_t)bytes[0] << 24 | (uint32_t)bytes[1] << 16 | (uint32_t)bytes[2] << 8 | bytes[3];
+}
+
+static inline void rain__qoi_write_u32_(uint8_t *bytes, uint32_t v) {
+	bytes[0] = v >> 24;
+	bytes[1] = v >> 16;
+	bytes[2] = v >> 8;
+	bytes[3] = v;
+}
+
+static bool rain__qoi_valid_desc_(const struct rain_qoi_desc *desc) {
+	return desc->width > 0 && desc->height > 0
+		&& (desc->channels == 3 || desc->channels == 4)
+		&& desc->colorspace <= 1
+		&& desc->height < RAIN_QOI_PIXELS_MAX / desc->width;
+}
+
+bool rain_qoi_read_header(
+	const uint8_t *restrict data,
+	size_t size,
+	struct rain_qoi_desc *restrict out_desc
+) {
+	if (size < RAIN_QOI_HEADER_SIZE || memcmp(data, "qoif", 4) != 0) return false;
+	*out_desc = (struct rain_qoi_desc){
+		.width = rain__qoi_read_u32_(data + 4),
+		.height = rain__qoi_read_u32_(data + 8),
+		.channels = data[12],
+		.colorspace = data[13],
+	};
+	return rain__qoi_valid_desc_(out_desc);
+}
+
+/** `channels` is a constant in both calls, so each gets its own loop
+    with fixed size stores. */
+[[gnu::always_inline]] static inline void rain__qoi_decode_(
+	const uint8_t *restrict data,
+	size_t size,
+	const struct rain_qoi_desc *desc,
+	uint8_t *restrict pixels,
+	const int channels,
+	bool flip_vertically
+) {
+	size_t row_bytes = (size_t)desc->width * channels;
+	union rain__qoi_px_ index[64] = {};
+	union rain__qoi_px_ px = { .rgba = { 0, 0, 0, 255 } };
+	// every op is at most 5 bytes, the padding keeps the reads in bounds.
+	size_t at = RAIN_QOI_HEADER_SIZE, end = size - RAIN__QOI_PADDING_SIZE_;
+	size_t run = 0;
+	for (uint32_t y = 0; y < desc->height; ++y) {
+		uint8_t *out = pixels + row_bytes * (flip_vertically ? desc->height - 1 - y : y);
+		uint8_t *row_end = out + row_bytes;
+		while (out < row_end) {
+			if (run > 0) {
+				// runs are the bulk of flat images, fill them in one go.
+				size_t left = (size_t)(row_end - out) / channels;
+				size_t count = run < left ? run : left;
+				for (size_t i = 0; i < count; ++i, out += channels) memcpy(out, &px, channels);
+				run -= count;
+				continue;
+			}
+			if (at >= end) {
+				// truncated files end in whatever the last pixel was.
+				run = SIZE_MAX;
+				continue;
+			}
+
+			uint8_t b1 = data[at++];
+			if (b1 == RAIN__QOI_OP_RGB_) {
+				px.rgba.r = data[at];
+				px.rgba.g = data[at + 1];
+				px.rgba.b = data[at + 2];
+				at += 3;
+			} else if (b1 == RAIN__QOI_OP_RGBA_) {
+				memcpy(&px, data + at, 4);
+				at += 4;
+			} else switch (b1 & RAIN__QOI_MASK_) {
+			case RAIN__QOI_OP_INDEX_:
+				px = index[b1];
+				break;
+			case RAIN__QOI_OP_DIFF_:
+				px.rgba.r += ((b1 >> 4) & 0x03) - 2;
+				px.rgba.g += ((b1 >> 2) & 0x03) - 2;
+				px.rgba.b += (b1 & 0x03) - 2;
+				break;
+			case RAIN__QOI_OP_LUMA_: {
+				uint8_t b2 = data[at++];
+				int vg = (b1 & 0x3f) - 32;
+				px.rgba.r += vg - 8 + ((b2 >> 4) & 0x0f);
+				px.rgba.g += vg;
+				px.rgba.b += vg - 8 + (b2 & 0x0f);
+				break;
+			}
+			case RAIN__QOI_OP_RUN_:
+				run = (b1 & 0x3f) + 1;
+				break;
+			}
+			index[rain__qoi_hash_(px)] = px;
+			if (run == 0) {
+				memcpy(out, &px, channels);
+				out += channels;
+			}
+		}
+	}
+}
+
+uint8_t *rain_qoi_decode(
+	const uint8_t *restrict data,
+	size_t size,
+	int channels,
+	bool flip_vertically,
+	struct rain_qoi_desc *restrict out_desc
+) {
+	struct rain_qoi_desc desc;
+	if (size < RAIN_QOI_HEADER_SIZE + RAIN__QOI_PADDING_SIZE_) return nullptr;
+	if (!rain_qoi_read_header(data, size, &desc)) return nullptr;
+	if (channels == 0) channels = desc.channels;
+	if (channels != 3 && channels != 4) return nullptr;
+
+	uint8_t *pixels = malloc((size_t)desc.width * desc.height * channels);
+	if (!pixels) return nullptr;
+	if (channels == 4) rain__qoi_decode_(data, size, &desc, pixels, 4, flip_vertically);
+	else rain__qoi_decode_(data, size, &desc, pixels, 3, flip_vertically);
+
+	if (out_desc) *out_desc = desc;
+	return pixels;
+}
+
+uint8_t *rain_qoi_encode(
+	const uint8_t *restrict pixels,
+	const struct rain_qoi_desc *restrict desc,
+	size_t *restrict out_size
+) {
+	if (!rain__qoi_valid_desc_(desc)) return nullptr;
+	size_t count = (size_t)desc->width * desc->height;
+	uint8_t *bytes = malloc(RAIN_QOI_HEADER_SIZE
+		+ count * (desc->channels + 1) + RAIN__QOI_PADDING_SIZE_);
+	if (!bytes) return nullptr;
+
+	memcpy(bytes, "qoif", 4);
+	rain__qoi_write_u32_(bytes + 4, desc->width);
+	rain__qoi_write_u32_(bytes + 8, desc->height);
+	bytes[12] = desc->channels;
+	bytes[13] = desc->colorspace;
+	size_t at = RAIN_QOI_HEADER_SIZE;
+
+	union rain__qoi_px_ index[64] = {};
+	union rain__qoi_px_ prev = { .rgba = { 0, 0, 0, 255 } }, px = prev;
+	int run = 0;
+	for (size_t i = 0; i < count; ++i, pixels += desc->channels) {
+		memcpy(&px, pixels, desc->channels);
+
+		if (px.v == prev.v) {
+			if (++run == 62 || i == count - 1) {
+				bytes[at++] = RAIN__QOI_OP_RUN_ | (run - 1);
+				run = 0;
+			}
+			continue;
+		}
+		if (run > 0) {
+			bytes[at++] = RAIN__QOI_OP_RUN_ | (run - 1);
+			run = 0;
+		}
+
+		int hash = rain__qoi_hash_(px);
+		if (index[hash].v == px.v) {
+			bytes[at++] = RAIN__QOI_OP_INDEX_ | hash;
+		} else {
+			index[hash] = px;
+			if (px.rgba.a == prev.rgba.a) {
+				int8_t vr = px.rgba.r - prev.rgba.r;
+				int8_t vg = px.rgba.g - prev.rgba.g;
+				int8_t vb = px.rgba.b - prev.rgba.b;
+				int8_t vg_r = vr - vg, vg_b = vb - vg;
+				if (vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2) {
+					bytes[at++] = RAIN__QOI_OP_DIFF_ | (vr + 2) << 4 | (vg + 2) << 2 | (vb + 2);
+				} else if (vg_r > -9 && vg_r < 8 && vg > -33 && vg < 32 && vg_b > -9 && vg_b < 8) {
+					bytes[at++] = RAIN__QOI_OP_LUMA_ | (vg + 32);
+					bytes[at++] = (vg_r + 8) << 4 | (vg_b + 8);
+				} else {
+					bytes[at++] = RAIN__QOI_OP_RGB_;
+					bytes[at++] = px.rgba.r;
+					bytes[at++] = px.rgba.g;
+					bytes[at++] = px.rgba.b;
+				}
+			} else {
+				bytes[at++] = RAIN__QOI_OP_RGBA_;
+				memcpy(bytes + at, &px, 4);
+				at += 4;
+			}
+		}
+		prev = px;
+	}
+
+	memcpy(bytes + at, rain__qoi_padding_, RAIN__QOI_PADDING_SIZE_);
+	*out_size = at + RAIN__QOI_PADDING_SIZE_;
+	return bytes;
+}
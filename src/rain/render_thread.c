@@ -0,0 +1,339 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <threads.h>
+#include <stdatomic.h>
+#include "render_thread.h"
+
+#define RAIN__RENDER_ALIGN_(SIZE) (((SIZE) + 15) & ~(size_t)15)
+
+struct rain__render_cmd_ {
+	rain_render_fn fn;
+	/** of the whole command, payload included. */
+	size_t size;
+};
+
+struct rain__render_list_ {
+	uint8_t *data;
+	size_t size, capacity;
+};
+
+static struct {
+	struct rain_window *window;
+	/** between init and deinit, frames are being recorded. only changed
+	    under `garbage_lock`, which releases from other threads take. */
+	atomic_bool active;
+	bool async;
+	/** the one that called init, its context is current again after deinit. */
+	thrd_t main_thread;
+	thrd_t thread;
+
+	/** the main thread records into one while the other is executed. */
+	struct rain__render_list_ lists[2];
+	int recording;
+
+	mtx_t lock;
+	/** wakes the render thread. */
+	cnd_t wake;
+	/** signalled by the render thread when a frame or sync call is done. */
+	cnd_t done;
+	bool frame_ready;
+	rain_render_fn sync_fn;
+	void *sync_arg;
+	bool quit;
+
+	/** resources released from any thread (e.g. the GC finalizer thread),
+	    destroyed at the end of the next submitted frame. the lock lives
+	    as long as the process, releases may come after deinit. */
+	mtx_t garbage_lock;
+	struct rain__render_garbage_ *garbage;
+	size_t garbage_count, garbage_capacity;
+} render_;
+
+struct rain__render_garbage_ {
+	enum { RAIN__GARBAGE_IMAGE_, RAIN__GARBAGE_PASS_, RAIN__GARBAGE_MEMORY_ } kind;
+	union {
+		uint32_t id;
+		void *memory;
+	};
+};
+
+static void rain__render_collect_(struct rain__render_garbage_ *garbage, size_t count) {
+	for (size_t i = 0; i < count; ++i) {
+		switch (garbage[i].kind) {
+		case RAIN__GARBAGE_IMAGE_: sg_destroy_image((sg_image){ garbage[i].id }); break;
+		case RAIN__GARBAGE_PASS_: sg_destroy_pass((sg_pass){ garbage[i].id }); break;
+		case RAIN__GARBAGE_MEMORY_: free(garbage[i].memory); break;
+		}
+	}
+}
+
+struct rain__render_collect_cmd_ {
+	size_t count;
+	struct rain__render_garbage_ garbage[];
+};
+
+static void rain__render_collect_cmd_(void *payload) {
+	struct rain__render_collect_cmd_ *cmd = payload;
+	rain__render_collect_(cmd->garbage, cmd->count);
+}
+
+/** record destroying everything released so far after the frame's commands. */
+static void rain__render_flush_garbage_() {
+	mtx_lock(&render_.garbage_lock);
+	if (render_.garbage_count > 0) {
+		size_t size = render_.garbage_count * sizeof(struct rain__render_garbage_);
+		struct rain__render_collect_cmd_ *cmd = rain_render_thread_push(
+			&rain__render_collect_cmd_, sizeof(*cmd) + size);
+		cmd->count = render_.garbage_count;
+		memcpy(cmd->garbage, render_.garbage, size);
+		render_.garbage_count = 0;
+	}
+	mtx_unlock(&render_.garbage_lock);
+}
+
+static void rain__render_release_(struct rain__render_garbage_ garbage) {
+	mtx_lock(&render_.garbage_lock);
+	if (atomic_load(&render_.active)) {
+		if (render_.garbage_count == render_.garbage_capacity) {
+			render_.garbage_capacity = render_.garbage_capacity ? render_.garbage_capacity * 2 : 64;
+			render_.garbage = realloc(render_.garbage,
+				render_.garbage_capacity * sizeof(struct rain__render_garbage_));
+		}
+		render_.garbage[render_.garbage_count++] = garbage;
+		mtx_unlock(&render_.garbage_lock);
+		return;
+	}
+	mtx_unlock(&render_.garbage_lock);
+
+	// nothing is recorded anymore, only the main thread has a context.
+	if (garbage.kind == RAIN__GARBAGE_MEMORY_
+			|| thrd_equal(thrd_current(), render_.main_thread)) {
+		rain__render_collect_(&garbage, 1);
+	} else {
+		fprintf(stderr, "render/WARN resource %u released after shutdown off the main thread, dropped.\n",
+			garbage.id);
+	}
+}
+
+static void rain__render_execute_(struct rain__render_list_ *list, bool present) {
+	for (size_t at = 0; at < list->size;) {
+		struct rain__render_cmd_ *cmd = (struct rain__render_cmd_ *)(list->data + at);
+		cmd->fn(list->data + at + RAIN__RENDER_ALIGN_(sizeof(*cmd)));
+		at += cmd->size;
+	}
+	list->size = 0;
+	if (present) rain_window_swap(render_.window);
+}
+
+static int rain__render_thread_main_(void *arg) {
+	rain_window_make_current(render_.window, true);
+
+	mtx_lock(&render_.lock);
+	for (;;) {
+		while (!render_.quit && !render_.sync_fn && !render_.frame_ready) {
+			cnd_wait(&render_.wake, &render_.lock);
+		}
+		if (render_.sync_fn) {
+			mtx_unlock(&render_.lock);
+			render_.sync_fn(render_.sync_arg);
+			mtx_lock(&render_.lock);
+			render_.sync_fn = nullptr;
+			cnd_broadcast(&render_.done);
+		} else if (render_.frame_ready) {
+			mtx_unlock(&render_.lock);
+			rain__render_execute_(&render_.lists[!render_.recording], true);
+			mtx_lock(&render_.lock);
+			render_.frame_ready = false;
+			cnd_broadcast(&render_.done);
+		} else {
+			break;
+		}
+	}
+	mtx_unlock(&render_.lock);
+
+	rain_window_make_current(render_.window, false);
+	return 0;
+}
+
+static once_flag rain__render_garbage_once_ = ONCE_FLAG_INIT;
+
+static void rain__render_garbage_init_() {
+	mtx_init(&render_.garbage_lock, mtx_plain);
+}
+
+void rain_render_thread_init(struct rain_window *window) {
+	render_.window = window;
+	render_.main_thread = thrd_current();
+	call_once(&rain__render_garbage_once_, &rain__render_garbage_init_);
+	atomic_store(&render_.active, true);
+	render_.async = true;
+	const char *mode = getenv("RAIN_RENDER_THREAD");
+	if (mode != nullptr && strcmp(mode, "off") == 0) render_.async = false;
+	else if (mode != nullptr && strcmp(mode, "on") != 0) {
+		fprintf(stderr, "render/WARN unknown RAIN_RENDER_THREAD '%s', using 'on'.\n", mode);
+	}
+	if (!render_.async) return;
+
+	mtx_init(&render_.lock, mtx_plain);
+	cnd_init(&render_.wake);
+	cnd_init(&render_.done);
+	// a context can only be current on one thread.
+	rain_window_make_current(window, false);
+	if (thrd_create(&render_.thread, &rain__render_thread_main_, nullptr) != thrd_success) {
+		fprintf(stderr, "render/ERR failed to start the render thread, rendering synchronously.\n");
+		rain_window_make_current(window, true);
+		render_.async = false;
+	}
+}
+
+void rain_render_thread_deinit() {
+	// nothing is queued after this, so the last flush gets everything.
+	mtx_lock(&render_.garbage_lock);
+	atomic_store(&render_.active, false);
+	mtx_unlock(&render_.garbage_lock);
+	rain__render_flush_garbage_();
+	if (render_.async) {
+		mtx_lock(&render_.lock);
+		while (render_.frame_ready) cnd_wait(&render_.done, &render_.lock);
+		render_.quit = true;
+		cnd_signal(&render_.wake);
+		mtx_unlock(&render_.lock);
+		thrd_join(render_.thread, nullptr);
+
+		cnd_destroy(&render_.done);
+		cnd_destroy(&render_.wake);
+		mtx_destroy(&render_.lock);
+		rain_window_make_current(render_.window, true);
+		// whatever gets destroyed after this happens right here.
+		render_.async = false;
+	}
+	// recorded after the last submit, e.g. destroying resources.
+	rain__render_execute_(&render_.lists[render_.recording], false);
+	for (int i = 0; i < 2; ++i) {
+		free(render_.lists[i].data);
+		render_.lists[i] = (struct rain__render_list_){};
+	}
+	mtx_lock(&render_.garbage_lock);
+	free(render_.garbage);
+	render_.garbage = nullptr;
+	render_.garbage_count = render_.garbage_capacity = 0;
+	mtx_unlock(&render_.garbage_lock);
+}
+
+bool rain_render_thread_is_async() {
+	return render_.async;
+}
+
+void *rain_render_thread_push(rain_render_fn fn, size_t size) {
+	struct rain__render_list_ *list = &render_.lists[render_.recording];
+	size_t header = RAIN__RENDER_ALIGN_(sizeof(struct rain__render_cmd_));
+	size_t total = header + RAIN__RENDER_ALIGN_(size);
+	if (list->size + total > list->capacity) {
+		size_t capacity = list->capacity ? list->capacity : 64 * 1024;
+		while (capacity < list->size + total) capacity *= 2;
+		list->data = realloc(list->data, capacity);
+		list->capacity = capacity;
+	}
+	struct rain__render_cmd_ *cmd = (struct rain__render_cmd_ *)(list->data + list->size);
+	cmd->fn = fn;
+	cmd->size = total;
+	list->size += total;
+	return (uint8_t *)cmd + header;
+}
+
+void rain_render_thread_call(rain_render_fn fn, const void *payload, size_t size) {
+	if (!atomic_load(&render_.active)) {
+		// nothing is recorded, run it now.
+		fn((void *)payload);
+		return;
+	}
+	memcpy(rain_render_thread_push(fn, size), payload, size);
+}
+
+void rain_render_thread_sync(rain_render_fn fn, void *arg) {
+	if (!render_.async) {
+		fn(arg);
+		return;
+	}
+	mtx_lock(&render_.lock);
+	// one at a time, in case another thread is creating resources too.
+	while (render_.sync_fn) cnd_wait(&render_.done, &render_.lock);
+	render_.sync_fn = fn;
+	render_.sync_arg = arg;
+	cnd_signal(&render_.wake);
+	while (render_.sync_fn == fn && render_.sync_arg == arg) {
+		cnd_wait(&render_.done, &render_.lock);
+	}
+	mtx_unlock(&render_.lock);
+}
+
+void rain_render_thread_submit() {
+	rain__render_flush_garbage_();
+	if (!render_.async) {
+		rain__render_execute_(&render_.lists[render_.recording], true);
+		return;
+	}
+	mtx_lock(&render_.lock);
+	while (render_.frame_ready) cnd_wait(&render_.done, &render_.lock);
+	render_.recording = !render_.recording;
+	render_.frame_ready = true;
+	cnd_signal(&render_.wake);
+	mtx_unlock(&render_.lock);
+}
+
+struct rain__render_make_image_ {
+	const sg_image_desc *desc;
+	rain_render_image_fn init;
+	const void *init_arg;
+	sg_image image;
+};
+
+static void rain__render_make_image_(void *arg) {
+	struct rain__render_make_image_ *make = arg;
+	make->image = sg_make_image(make->desc);
+	if (make->init) make->init(make->image, make->init_arg);
+}
+
+sg_image rain_render_thread_make_image(const sg_image_desc *desc) {
+	return rain_render_thread_make_image_with(desc, nullptr, nullptr);
+}
+
+sg_image rain_render_thread_make_image_with(
+	const sg_image_desc *desc,
+	rain_render_image_fn init,
+	const void *arg
+) {
+	struct rain__render_make_image_ make = { .desc = desc, .init = init, .init_arg = arg };
+	rain_render_thread_sync(&rain__render_make_image_, &make);
+	return make.image;
+}
+
+void rain_render_thread_destroy_image(sg_image image) {
+	rain__render_release_((struct rain__render_garbage_){ RAIN__GARBAGE_IMAGE_, .id = image.id });
+}
+
+struct rain__render_make_pass_ {
+	const sg_pass_desc *desc;
+	sg_pass pass;
+};
+
+static void rain__render_make_pass_(void *arg) {
+	struct rain__render_make_pass_ *make = arg;
+	make->pass = sg_make_pass(make->desc);
+}
+
+sg_pass rain_render_thread_make_pass(const sg_pass_desc *desc) {
+	struct rain__render_make_pass_ make = { .desc = desc };
+	rain_render_thread_sync(&rain__render_make_pass_, &make);
+	return make.pass;
+}
+
+void rain_render_thread_destroy_pass(sg_pass pass) {
+	rain__render_release_((struct rain__render_garbage_){ RAIN__GARBAGE_PASS_, .id = pass.id });
+}
+
+void rain_render_thread_free(void *memory) {
+	rain__render_release_((struct rain__render_garbage_){ RAIN__GARBAGE_MEMORY_, .memory = memory });
+}
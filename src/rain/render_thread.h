@@ -0,0 +1,69 @@
+#ifndef RAIN__RENDER_THREAD_H_
+#define RAIN__RENDER_THREAD_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <sokol_gfx.h>
+#include <rain/window.h>
+
+/** a recorded command, gets the payload it was pushed with. */
+typedef void (*rain_render_fn)(void *payload);
+
+/** move the GL context and all sokol calls to a render thread.
+    `RAIN_RENDER_THREAD=off` keeps them on the main thread instead,
+    which replays each frame right away at submit (for debugging).
+    call after `rain_renderer_init`. */
+void rain_render_thread_init(struct rain_window *window);
+
+/** finish the last frame, join the thread and take the context back. */
+void rain_render_thread_deinit();
+
+/** true if frames are executed on a separate thread. */
+bool rain_render_thread_is_async();
+
+/** append `fn` to the frame being recorded and return `size` bytes of
+    payload for it, valid until the next push. commands run in order. */
+void *rain_render_thread_push(rain_render_fn fn, size_t size);
+
+/** push `fn` with a copy of `payload`, e.g. to destroy resources after
+    the commands using them. runs it right away outside of
+    `rain_render_thread_init`/`deinit`, when no frames are recorded. */
+void rain_render_thread_call(rain_render_fn fn, const void *payload, size_t size);
+
+/** run `fn(arg)` with the GL context and wait for it, e.g. to create
+    resources. runs between frames, before the frame being recorded. */
+void rain_render_thread_sync(rain_render_fn fn, void *arg);
+
+/** resource helpers. creation waits for the render thread.
+    destruction may be requested from any thread, it is queued and
+    happens at the end of the next submitted frame, after every
+    command that might still use the resource. after deinit it happens
+    right away on the main thread and is dropped (logged) on others. */
+sg_image rain_render_thread_make_image(const sg_image_desc *desc);
+
+typedef void (*rain_render_image_fn)(sg_image image, const void *arg);
+
+/** same, then `init(image, arg)` with the context, before any frame
+    can use the image. for GL state sokol has no desc field for. */
+sg_image rain_render_thread_make_image_with(
+	const sg_image_desc *desc,
+	rain_render_image_fn init,
+	const void *arg
+);
+void rain_render_thread_destroy_image(sg_image image);
+sg_pass rain_render_thread_make_pass(const sg_pass_desc *desc);
+void rain_render_thread_destroy_pass(sg_pass pass);
+/** `free` memory that recorded commands may still point to, same as above. */
+void rain_render_thread_free(void *memory);
+
+/** render thread only. the GL texture sokol holds `image` in, 0 if it
+    was destroyed. for uploads sokol has no call for, `sg_reset_state_cache`
+    after binding it. */
+uint32_t rain_render_thread_gl_texture(sg_image image);
+
+/** hand the recorded frame over and start recording the next one.
+    waits until the previous frame was executed and presented. */
+void rain_render_thread_submit();
+
+#endif // RAIN__RENDER_THREAD_H_
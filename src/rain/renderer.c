@@ -1,9 +1,12 @@
 #include <stdio.h>
+#include <threads.h>
 
 #include <rain/renderer.h>
 
 #include <GL/gl3w.h>
 #include "glfw.h"
+#include "render_thread.h"
+#include "upload_ring.h"
 
 enum rain__uniform_block_index_ {
 	RAIN__UNIFORM_BLOCK_INDEX_GLOBAL_ = 0,
@@ -29,41 +32,139 @@ void logger_for_sg(
 	fprintf(stderr, "%s/%s %s (sokol_gfx.h:%d)\n", tag, log_level_string, message, lineno);
 }
 
+/** per draw uniforms of every material shader, see material.c. */
 struct rain__ub_data_quad_ {
-	rain_float4x4 trans;
-};
-
-struct rain__ub_data_colored_quad_ {
-	struct rain__ub_data_colored_quad_vs_ {
-		struct rain__ub_data_quad_ quad;
-	} vs;
-	struct rain__ub_data_colored_quad_fs_ {
-		rain_float4 color;
-	} fs;
-};
-
-struct rain__ub_data_textured_quad_ {
-	struct rain__ub_data_textured_quad_vs_ {
-		struct rain__ub_data_quad_ quad;
+	struct rain__ub_data_quad_vs_ {
+		rain_float4x4 trans;
 		rain_float4 uvs;
 	} vs;
-	struct rain__ub_data_textured_quad_fs_ {
+	struct rain__ub_data_quad_fs_ {
 		rain_float4 tint;
 	} fs;
-	struct rain__ub_data_textured_quad_bind_ {
-		uint32_t texture;
-	} bind;
 };
 
+/** published by the render thread at the end of each frame. */
+static struct {
+	mtx_t lock;
+	struct rain_renderer_stats last;
+} renderer_stats_;
+
 static inline void rain___renderer_bind_pipeline(struct rain_renderer *this, sg_pipeline pipeline) {
 	if (this->current_.pipeline.id != pipeline.id) {
 		this->current_.pipeline = pipeline;
 		sg_apply_pipeline(this->current_.pipeline);
+		// a new pipeline needs its bindings applied again.
+		this->current_.bind_dirty = true;
 	}
 }
 
 static inline void rain___renderer_bind_vertex_buffer(struct rain_renderer *this, sg_buffer buffer) {
-	this->current_.bind.vertex_buffers[0] = buffer;
+	if (this->current_.bind.vertex_buffers[0].id != buffer.id) {
+		this->current_.bind.vertex_buffers[0] = buffer;
+		this->current_.bind_dirty = true;
+	}
+}
+
+static inline void rain___renderer_bind_image(struct rain_renderer *this, sg_image image, sg_sampler sampler) {
+	if (this->current_.bind.fs.images[0].id != image.id
+		|| this->current_.bind.fs.samplers[0].id != sampler.id) {
+		this->current_.bind.fs.images[0] = image;
+		this->current_.bind.fs.samplers[0] = sampler;
+		this->current_.bind_dirty = true;
+	}
+}
+
+static inline void rain___renderer_apply_bindings(struct rain_renderer *this) {
+	if (this->current_.bind_dirty) {
+		sg_apply_bindings(&this->current_.bind);
+		this->current_.bind_dirty = false;
+	}
+}
+
+// counted for every caller of sokol on the render thread, not just the
+// quads. the hooks run on whichever thread calls sokol, which is the
+// render thread or, before it starts and after it stops, the main thread.
+
+static uint64_t rain__renderer_image_memory_(sg_image image) {
+	if (sg_query_image_state(image) != SG_RESOURCESTATE_VALID) return 0;
+	sg_image_desc desc = sg_query_image_desc(image);
+	uint64_t pixel_bytes;
+	switch (desc.pixel_format) {
+	case SG_PIXELFORMAT_R8: pixel_bytes = 1; break;
+	case SG_PIXELFORMAT_RG8: pixel_bytes = 2; break;
+	case SG_PIXELFORMAT_RGBA16F: pixel_bytes = 8; break;
+	case SG_PIXELFORMAT_RGBA32F: pixel_bytes = 16; break;
+	default: pixel_bytes = 4; break;
+	}
+	uint64_t bytes = 0;
+	for (int mip = 0; mip < desc.num_mipmaps; ++mip) {
+		uint64_t width = desc.width >> mip, height = desc.height >> mip;
+		bytes += (width ? width : 1) * (height ? height : 1);
+	}
+	int slices = desc.type == SG_IMAGETYPE_CUBE ? 6 : desc.num_slices;
+	return bytes * pixel_bytes * slices * (desc.sample_count > 1 ? desc.sample_count : 1);
+}
+
+static void rain__renderer_trace_make_buffer_(const sg_buffer_desc *desc, sg_buffer result, void *user_data) {
+	struct rain_renderer *this = user_data;
+	this->current_.stats.buffer_bytes += desc->data.ptr ? desc->data.size : 0;
+}
+
+static void rain__renderer_trace_make_image_(const sg_image_desc *desc, sg_image result, void *user_data) {
+	struct rain_renderer *this = user_data;
+	for (int face = 0; face < SG_CUBEFACE_NUM; ++face) {
+		for (int mip = 0; mip < SG_MAX_MIPMAPS; ++mip) {
+			this->current_.stats.image_bytes += desc->data.subimage[face][mip].size;
+		}
+	}
+	this->current_.stats.texture_memory += rain__renderer_image_memory_(result);
+}
+
+static void rain__renderer_trace_destroy_image_(sg_image image, void *user_data) {
+	struct rain_renderer *this = user_data;
+	// still alive, the hook runs first.
+	this->current_.stats.texture_memory -= rain__renderer_image_memory_(image);
+}
+
+static void rain__renderer_trace_update_buffer_(sg_buffer buffer, const sg_range *data, void *user_data) {
+	struct rain_renderer *this = user_data;
+	this->current_.stats.buffer_bytes += data->size;
+}
+
+static void rain__renderer_trace_append_buffer_(sg_buffer buffer, const sg_range *data, int result, void *user_data) {
+	struct rain_renderer *this = user_data;
+	this->current_.stats.buffer_bytes += data->size;
+}
+
+static void rain__renderer_trace_update_image_(sg_image image, const sg_image_data *data, void *user_data) {
+	struct rain_renderer *this = user_data;
+	for (int face = 0; face < SG_CUBEFACE_NUM; ++face) {
+		for (int mip = 0; mip < SG_MAX_MIPMAPS; ++mip) {
+			this->current_.stats.image_bytes += data->subimage[face][mip].size;
+		}
+	}
+}
+
+static void rain__renderer_trace_apply_pipeline_(sg_pipeline pipeline, void *user_data) {
+	struct rain_renderer *this = user_data;
+	this->current_.stats.pipeline_changes += 1;
+}
+
+static void rain__renderer_trace_apply_bindings_(const sg_bindings *bindings, void *user_data) {
+	struct rain_renderer *this = user_data;
+	this->current_.stats.binding_changes += 1;
+}
+
+static void rain__renderer_trace_apply_uniforms_(sg_shader_stage stage, int ub_index, const sg_range *data, void *user_data) {
+	struct rain_renderer *this = user_data;
+	this->current_.stats.uniform_applies += 1;
+	this->current_.stats.uniform_bytes += data->size;
+}
+
+static void rain__renderer_trace_draw_(int base_element, int num_elements, int num_instances, void *user_data) {
+	struct rain_renderer *this = user_data;
+	this->current_.stats.draws += 1;
+	this->current_.stats.instances += num_instances;
 }
 
 void rain_renderer_init(
@@ -71,130 +172,50 @@ void rain_renderer_init(
 	struct rain_window *restrict window
 ) {
 	this->window = window;
+	mtx_init(&renderer_stats_.lock, mtx_plain);
 
 	sg_setup(&(sg_desc) {
 		.context = rain_window_get_context(this->window),
 		.logger.func = &logger_for_sg,
 	});
-
-	this->builtin_.colored_quad_shader = sg_make_shader(&(sg_shader_desc){
-		.label = "Builtin Colored Quad Shader",
-		.vs = {
-			.uniform_blocks[0] = {
-				.size = sizeof(struct rain__ub_data_colored_quad_vs_),
-				.uniforms = {
-					[0] = { .name = "u_trans", .type = SG_UNIFORMTYPE_MAT4 },
-				},
-			},
-			.source = 
-				"#version 330\n"
-				"layout(location = 0) in vec2 i_position;\n"
-				"uniform mat4 u_trans;\n"
-				"void main() {\n"
-				"  gl_Position = vec4(i_position, 0.0, 1.0) * u_trans;\n"
-				"}\n",
-		},
-		.fs = {
-			.uniform_blocks[0] = {
-				.size = sizeof(struct rain__ub_data_colored_quad_fs_),
-				.uniforms = {
-					[0] = { .name = "u_color", .type = SG_UNIFORMTYPE_FLOAT4 },
-				},
-			},
-			.source = 
-				"#version 330\n"
-				"uniform vec4 u_color;\n"
-				"in vec2 s_uv;"
-				"out vec4 o_color;"
-				"void main() {\n"
-				"  o_color = u_color;"
-				"}\n",
-		}
+	sg_install_trace_hooks(&(sg_trace_hooks){
+		.user_data = this,
+		.make_buffer = &rain__renderer_trace_make_buffer_,
+		.make_image = &rain__renderer_trace_make_image_,
+		.destroy_image = &rain__renderer_trace_destroy_image_,
+		.update_buffer = &rain__renderer_trace_update_buffer_,
+		.append_buffer = &rain__renderer_trace_append_buffer_,
+		.update_image = &rain__renderer_trace_update_image_,
+		.apply_pipeline = &rain__renderer_trace_apply_pipeline_,
+		.apply_bindings = &rain__renderer_trace_apply_bindings_,
+		.apply_uniforms = &rain__renderer_trace_apply_uniforms_,
+		.draw = &rain__renderer_trace_draw_,
 	});
 
-	sg_blend_state blending = {
-		.enabled = true,
-		.src_factor_rgb = SG_BLENDFACTOR_SRC_ALPHA,
-		.dst_factor_rgb = SG_BLENDFACTOR_ONE_MINUS_SRC_ALPHA,
-		.op_rgb = SG_BLENDOP_ADD,
-		.src_factor_alpha = SG_BLENDFACTOR_ZERO,
-		.dst_factor_alpha = SG_BLENDFACTOR_ONE,
-		.op_alpha = SG_BLENDOP_ADD,
+	rain_shader_init(&this->builtin_.colored_quad_shader, "Builtin Colored Quad Shader",
+		"void main() {\n"
+		"  o_color = u_tint;\n"
+		"}\n",
+		0, false);
+	rain_shader_init(&this->builtin_.textured_quad_shader, "Builtin Textured Quad Shader",
+		"void main() {\n"
+		"  o_color = u_tint * texture(u_texture, s_uv);\n"
+		"}\n",
+		0, true);
+
+	// translucent: tested against the opaque draws before them, not written.
+	struct rain_material_state blending = {
+		.blend = RAIN_BLEND_ALPHA,
+		.depth_test = true,
 	};
-
-	this->builtin_.colored_quad_pipeline = sg_make_pipeline(&(sg_pipeline_desc){
-		.label = "Colored Quad Pipeline",
-		.layout.attrs[0].format = SG_VERTEXFORMAT_FLOAT2,
-		.shader = this->builtin_.colored_quad_shader,
-		.index_type = SG_INDEXTYPE_NONE,
-		.cull_mode = SG_CULLMODE_NONE,
-		.primitive_type = SG_PRIMITIVETYPE_TRIANGLE_STRIP,
-		.depth.pixel_format = SG_PIXELFORMAT_DEPTH_STENCIL,
-		.colors[0].blend = blending
-	});
-
-	this->builtin_.textured_quad_shader = sg_make_shader(&(sg_shader_desc){
-		.label = "Builtin Textured Quad Shader",
-		.vs = {
-			.uniform_blocks[0] = {
-				.size = sizeof(struct rain__ub_data_textured_quad_vs_),
-				.uniforms = {
-					[0] = { .name = "u_trans", .type = SG_UNIFORMTYPE_MAT4 },
-					[1] = { .name = "u_uvs", .type = SG_UNIFORMTYPE_FLOAT4 },
-				},
-			},
-			.source = 
-				"#version 330\n"
-				"layout(location = 0) in vec2 i_position;\n"
-				"uniform mat4 u_trans;\n"
-				"uniform vec4 u_uvs;\n"
-				"out vec2 s_uv;\n"
-				"void main() {\n"
-				"  vec2[] texcoords = vec2[](\n"
-				"    u_uvs.xy, vec2(u_uvs.z, u_uvs.y),\n"
-				"    vec2(u_uvs.x, u_uvs.w), u_uvs.zw \n"
-				"  );\n"
-				"  gl_Position = vec4(i_position, 0.0, 1.0) * u_trans;\n"
-				"  s_uv = texcoords[gl_VertexID];\n"
-				"}\n",
-		},
-		.fs = {
-			.images[0].used = true,
-			.samplers[0].used = true,
-			.image_sampler_pairs[0] = {
-				.used = true,
-				.glsl_name = "u_texture",
-				.image_slot = 0,
-				.sampler_slot = 0
-			},
-			.uniform_blocks[0] = {
-				.size = sizeof(struct rain__ub_data_textured_quad_fs_),
-				.uniforms = {
-					[0] = { .name = "u_tint", .type = SG_UNIFORMTYPE_FLOAT4 },
-				},
-			},
-			.source = 
-				"#version 330\n"
-				"uniform sampler2D u_texture;\n"
-				"uniform vec4 u_tint;\n"
-				"in vec2 s_uv;"
-				"out vec4 o_color;"
-				"void main() {\n"
-				"  o_color = u_tint * texture(u_texture, s_uv);"
-				"}\n",
-		}
-	});
-
-	this->builtin_.textured_quad_pipeline = sg_make_pipeline(&(sg_pipeline_desc){
-		.label = "Textured Quad Pipeline",
-		.layout.attrs[0].format = SG_VERTEXFORMAT_FLOAT2,
-		.shader = this->builtin_.textured_quad_shader,
-		.index_type = SG_INDEXTYPE_NONE,
-		.cull_mode = SG_CULLMODE_NONE,
-		.primitive_type = SG_PRIMITIVETYPE_TRIANGLE_STRIP,
-		.depth.pixel_format = SG_PIXELFORMAT_DEPTH_STENCIL,
-		.colors[0].blend = blending
-	});
+	rain_material_init(&this->builtin_.colored_quad_material,
+		&this->builtin_.colored_quad_shader, blending);
+	rain_material_init(&this->builtin_.textured_quad_material,
+		&this->builtin_.textured_quad_shader, blending);
+	// counts layers, so nothing may be hidden by depth.
+	rain_material_init(&this->builtin_.overdraw_material,
+		&this->builtin_.colored_quad_shader,
+		(struct rain_material_state){ .blend = RAIN_BLEND_ADDITIVE });
 
 	this->builtin_.quad_vertex_buffer = sg_make_buffer(&(sg_buffer_desc){
 		.label = "Quad Vertex Buffer",
@@ -211,26 +232,82 @@ void rain_renderer_init(
 		.min_filter = SG_FILTER_NEAREST,
     .mag_filter = SG_FILTER_NEAREST,
 	});
+	rain_upload_ring_init();
 }
 
 void rain_renderer_deinit(struct rain_renderer *this) {
+	rain_upload_ring_deinit();
 	sg_destroy_sampler(this->builtin_.nearest_sampler);
 	sg_destroy_buffer(this->builtin_.quad_vertex_buffer);
-	sg_destroy_pipeline(this->builtin_.colored_quad_pipeline);
-	sg_destroy_pipeline(this->builtin_.textured_quad_pipeline);
-	sg_destroy_shader(this->builtin_.colored_quad_shader);
-	sg_destroy_shader(this->builtin_.textured_quad_shader);
+	rain_materials_deinit();
 	sg_shutdown();
+	mtx_destroy(&renderer_stats_.lock);
 }
 
-void rain_renderer_begin_render(struct rain_renderer *this) {
+// drawing is recorded and executed on the render thread,
+// `current_` belongs to the render thread.
+
+static void rain__renderer_begin_render_(void *payload) {
+	struct rain_renderer *this = *(struct rain_renderer **)payload;
 	// glPolygonMode(GL_FRONT_AND_BACK, GL_LINE); no support in sokol :c
+	rain_renderer_reset_state(this);
+	this->current_.stats = (struct rain_renderer_stats){
+		.texture_memory = this->current_.stats.texture_memory,
+	};
+	rain_upload_ring_begin_frame();
+}
+
+void rain_renderer_reset_state(struct rain_renderer *this) {
 	this->current_.bind = (sg_bindings){0};
+	this->current_.bind_dirty = true;
 	this->current_.pipeline.id = SG_INVALID_ID;
+	this->current_.material = nullptr;
 }
 
-void rain_renderer_end_render(struct rain_renderer *this) {
+void rain_renderer_begin_render(struct rain_renderer *this) {
+	*(struct rain_renderer **)rain_render_thread_push(
+		&rain__renderer_begin_render_, sizeof(this)) = this;
+}
+
+static void rain__renderer_end_render_(void *payload) {
+	struct rain_renderer *this = *(struct rain_renderer **)payload;
+	rain_upload_ring_end_frame(&this->current_.stats);
 	sg_commit();
+	mtx_lock(&renderer_stats_.lock);
+	renderer_stats_.last = this->current_.stats;
+	mtx_unlock(&renderer_stats_.lock);
+}
+
+void rain_renderer_end_render(struct rain_renderer *this) {
+	*(struct rain_renderer **)rain_render_thread_push(
+		&rain__renderer_end_render_, sizeof(this)) = this;
+}
+
+struct rain__renderer_debug_view_cmd_ {
+	struct rain_renderer *renderer;
+	enum rain_renderer_debug_view view;
+};
+
+static void rain__renderer_set_debug_view_(void *payload) {
+	struct rain__renderer_debug_view_cmd_ *cmd = payload;
+	cmd->renderer->current_.debug_view = cmd->view;
+}
+
+void rain_renderer_set_debug_view(
+	struct rain_renderer *this,
+	enum rain_renderer_debug_view view
+) {
+	struct rain__renderer_debug_view_cmd_ cmd = { this, view };
+	rain_render_thread_call(&rain__renderer_set_debug_view_, &cmd, sizeof(cmd));
+}
+
+void rain_renderer_get_stats(
+	struct rain_renderer *restrict this,
+	struct rain_renderer_stats *restrict out_stats
+) {
+	mtx_lock(&renderer_stats_.lock);
+	*out_stats = renderer_stats_.last;
+	mtx_unlock(&renderer_stats_.lock);
 }
 
 // void rain__renderer_compute_trans_matrix_(
@@ -248,94 +325,141 @@ void rain_renderer_end_render(struct rain_renderer *this) {
 // 	);
 // }
 
-void rain_renderer_render_textured_quad(
+struct rain__renderer_quad_cmd_ {
+	struct rain_renderer *renderer;
+	const struct rain_material *material;
+	sg_image image;
+	sg_sampler sampler;
+	struct rain__ub_data_quad_ info;
+};
+
+static void rain__renderer_quad_(void *payload);
+
+void rain_renderer_render_quad(
 	struct rain_renderer *restrict this,
+	const struct rain_material *restrict material,
 	const struct rain_texture *restrict texture,
 	const struct sg_sampler sampler,
 	const struct rain_renderer_rect *restrict rect,
 	const rain_float4 *restrict tint,
 	const rain_float4x4 *restrict transform
 ) {
+	struct rain__renderer_quad_cmd_ *cmd = rain_render_thread_push(
+		&rain__renderer_quad_, sizeof(*cmd));
+	cmd->renderer = this;
+	cmd->material = material;
+	cmd->info = (struct rain__ub_data_quad_){
+		.vs.trans = *transform,
+		.vs.uvs = { 0.0f, 0.0f, 1.0f, 1.0f },
+		.fs.tint = *tint,
+	};
+	if (!material->shader->textured) {
+		cmd->image.id = SG_INVALID_ID;
+		cmd->sampler.id = SG_INVALID_ID;
+		return;
+	}
+
 	struct rain_renderer_rect r = *rect;
 	if (r.width == 0) r.width = texture->width;
 	if (r.height == 0) r.height = texture->height;
-
-	struct rain__ub_data_textured_quad_ info = {
-		.vs.quad.trans = *transform,
-		.vs.uvs = {
-			.x = r.offset_x /(float) texture->width,
-			.y = r.offset_y /(float) texture->height,
-			.z = (r.width + r.offset_x) /(float) texture->width,
-			.w = (r.height + r.offset_y) /(float) texture->height,
-		},
-		.fs.tint = {
-			tint->x, tint->y, tint->z, tint->w
-		}
+	cmd->image = texture->image;
+	cmd->sampler = sampler;
+	cmd->info.vs.uvs = (rain_float4){
+		.x = r.offset_x /(float) texture->width,
+		.y = r.offset_y /(float) texture->height,
+		.z = (r.width + r.offset_x) /(float) texture->width,
+		.w = (r.height + r.offset_y) /(float) texture->height,
 	};
+}
 
-	rain___renderer_bind_pipeline(this, this->builtin_.textured_quad_pipeline);
-	rain___renderer_bind_vertex_buffer(this, this->builtin_.quad_vertex_buffer);
-
-	this->current_.bind.fs.images[0] = texture->image;
-	this->current_.bind.fs.samplers[0] = sampler;
+/** a color that's easy to tell apart from its neighbours. */
+static rain_float4 rain__renderer_debug_color_(uint32_t index) {
+	uint32_t h = index * 2654435761u;
+	return (rain_float4){
+		.x = 0.25f + 0.75f * ((h >> 24) & 0xff) / 255.0f,
+		.y = 0.25f + 0.75f * ((h >> 16) & 0xff) / 255.0f,
+		.z = 0.25f + 0.75f * ((h >> 8) & 0xff) / 255.0f,
+		.w = 1.0f,
+	};
+}
 
-	sg_apply_bindings(&this->current_.bind);
+static void rain__renderer_quad_(void *payload) {
+	struct rain__renderer_quad_cmd_ *cmd = payload;
+	struct rain_renderer *this = cmd->renderer;
+	const struct rain_material *material = cmd->material;
+	struct rain__ub_data_quad_fs_ fs = cmd->info.fs;
+	sg_image image = cmd->image;
+	sg_sampler sampler = cmd->sampler;
+
+	if (this->current_.debug_view == RAIN_RENDERER_DEBUG_VIEW_OVERDRAW) {
+		material = &this->builtin_.overdraw_material;
+		image.id = sampler.id = SG_INVALID_ID;
+		fs.tint = (rain_float4){ 0.12f, 0.05f, 0.02f, 1.0f };
+	}
 
-	sg_apply_uniforms(
-		SG_SHADERSTAGE_VS,
-		0,
-		&(sg_range){
-			.ptr = (uint8_t*)&info + offsetof(struct rain__ub_data_textured_quad_, vs),
-			.size = sizeof(struct rain__ub_data_textured_quad_vs_)
-		}
-	);
-
-	sg_apply_uniforms(
-		SG_SHADERSTAGE_FS,
-		0,
-		&(sg_range){
-			.ptr = (uint8_t*)&info + offsetof(struct rain__ub_data_textured_quad_, fs),
-			.size = sizeof(struct rain__ub_data_textured_quad_fs_)
+	// sorted draws share these with their neighbours, so most are skipped.
+	struct rain_renderer_stats before = this->current_.stats;
+	rain___renderer_bind_pipeline(this, material->pipeline);
+	rain___renderer_bind_vertex_buffer(this, this->builtin_.quad_vertex_buffer);
+	rain___renderer_bind_image(this, image, sampler);
+	rain___renderer_apply_bindings(this);
+
+	switch (this->current_.debug_view) {
+	case RAIN_RENDERER_DEBUG_VIEW_BATCHES:
+		// every applied pipeline or binding starts a new batch.
+		fs.tint = rain__renderer_debug_color_(
+			this->current_.stats.pipeline_changes + this->current_.stats.binding_changes);
+		break;
+	case RAIN_RENDERER_DEBUG_VIEW_STATE_CHANGES:
+		if (this->current_.stats.pipeline_changes != before.pipeline_changes) {
+			fs.tint = (rain_float4){ 1.0f, 0.1f, 0.1f, 1.0f };
+		} else if (this->current_.stats.binding_changes != before.binding_changes) {
+			fs.tint = (rain_float4){ 1.0f, 0.9f, 0.1f, 1.0f };
+		} else {
+			fs.tint = (rain_float4){ 0.3f, 0.3f, 0.3f, 1.0f };
 		}
-	);
+		break;
+	default:
+		break;
+	}
+
+	sg_apply_uniforms(SG_SHADERSTAGE_VS, 0, &SG_RANGE(cmd->info.vs));
+	sg_apply_uniforms(SG_SHADERSTAGE_FS, 0, &SG_RANGE(fs));
+	// GL keeps uniforms with the program, so material params only
+	// go up when the material or its params change.
+	if (material->shader->param_count != 0 && (
+		this->current_.material != material
+		|| this->current_.material_version != material->render_version_
+	)) {
+		sg_apply_uniforms(SG_SHADERSTAGE_FS, 1, &(sg_range){
+			.ptr = material->render_params_,
+			.size = material->shader->param_count * sizeof(rain_float4),
+		});
+		this->current_.material = material;
+		this->current_.material_version = material->render_version_;
+		this->current_.stats.material_uploads += 1;
+	}
 
 	sg_draw(0, 4, 1);
 }
 
+void rain_renderer_render_textured_quad(
+	struct rain_renderer *restrict this,
+	const struct rain_texture *restrict texture,
+	const struct sg_sampler sampler,
+	const struct rain_renderer_rect *restrict rect,
+	const rain_float4 *restrict tint,
+	const rain_float4x4 *restrict transform
+) {
+	rain_renderer_render_quad(this, &this->builtin_.textured_quad_material,
+		texture, sampler, rect, tint, transform);
+}
+
 void rain_renderer_render_colored_quad(
 	struct rain_renderer *restrict this,
 	rain_float4 color,
 	const rain_float4x4 *restrict transform
 ) {
-	struct rain__ub_data_colored_quad_ info = {
-		.vs.quad.trans = *transform,
-		.fs.color = color
-	};
-	// rain__renderer_compute_trans_matrix_(this, &info.vs.quad.trans, transform);
-
-	rain___renderer_bind_pipeline(this, this->builtin_.colored_quad_pipeline);
-	rain___renderer_bind_vertex_buffer(this, this->builtin_.quad_vertex_buffer);
-
-	sg_apply_bindings(&this->current_.bind);
-
-	sg_apply_uniforms(
-		SG_SHADERSTAGE_VS,
-		0,
-		&(sg_range){
-			.ptr = (uint8_t*)&info + offsetof(struct rain__ub_data_colored_quad_, vs),
-			.size = sizeof(struct rain__ub_data_colored_quad_vs_)
-		}
-	);
-
-	sg_apply_uniforms(
-		SG_SHADERSTAGE_FS,
-		0,
-		&(sg_range){
-			.ptr = (uint8_t*)&info + offsetof(struct rain__ub_data_colored_quad_, fs),
-			.size = sizeof(struct rain__ub_data_colored_quad_fs_)
-		}
-	);
-
-	sg_draw(0, 4, 1);
+	rain_renderer_render_quad(this, &this->builtin_.colored_quad_material,
+		nullptr, (sg_sampler){}, nullptr, &color, transform);
 }
-
@@ -0,0 +1,69 @@
+#include <stdio.h>
+#include <mono/jit/jit.h>
+#include <mono/metadata/debug-helpers.h>
+#include "script.h"
+
+// unmanaged thunks take the managed arguments followed by an out exception.
+typedef void (*rain__script_thunk_)(MonoObject **exc);
+typedef void (*rain__script_thunk_float_)(float, MonoObject **exc);
+typedef void (*rain__script_thunk_int2_)(int, int, MonoObject **exc);
+
+static struct {
+	bool failed;
+	rain__script_thunk_ entry;
+	rain__script_thunk_float_ update;
+	rain__script_thunk_float_ fixed_update;
+	rain__script_thunk_float_ late_update;
+	rain__script_thunk_float_ render;
+	rain__script_thunk_int2_ resize;
+	rain__script_thunk_ destroy;
+} script_;
+
+static void *rain__script_find_thunk_(MonoImage *image, const char *name) {
+	MonoMethodDesc *desc = mono_method_desc_new(name, true);
+	MonoMethod *method = mono_method_desc_search_in_image(desc, image);
+	mono_method_desc_free(desc);
+	if (!method) {
+		fprintf(stderr, "script/WARN no method '%s'\n", name);
+		return nullptr;
+	}
+	return mono_method_get_unmanaged_thunk(method);
+}
+
+void rain_script_bind(MonoImage *image) {
+	script_.entry = rain__script_find_thunk_(image, "RainEngine.Main:Entry()");
+	script_.update = rain__script_find_thunk_(image, "RainEngine.Main:Update(single)");
+	script_.fixed_update = rain__script_find_thunk_(image, "RainEngine.Main:FixedUpdate(single)");
+	script_.late_update = rain__script_find_thunk_(image, "RainEngine.Main:LateUpdate(single)");
+	script_.render = rain__script_find_thunk_(image, "RainEngine.Main:Render(single)");
+	script_.resize = rain__script_find_thunk_(image, "RainEngine.Main:Resize(int,int)");
+	script_.destroy = rain__script_find_thunk_(image, "RainEngine.Main:Destroy()");
+}
+
+bool rain_script_failed() {
+	return script_.failed;
+}
+
+static void rain__script_check_(MonoObject *exc) {
+	if (exc) {
+		mono_print_unhandled_exception(exc);
+		script_.failed = true;
+	}
+}
+
+#define RAIN__SCRIPT_CALL_(THUNK, ...) \
+	do { \
+		if (script_.THUNK && !script_.failed) { \
+			MonoObject *exc = nullptr; \
+			script_.THUNK(__VA_ARGS__ &exc); \
+			rain__script_check_(exc); \
+		} \
+	} while (0)
+
+void rain_script_entry() { RAIN__SCRIPT_CALL_(entry); }
+void rain_script_update(float delta_time) { RAIN__SCRIPT_CALL_(update, delta_time,); }
+void rain_script_fixed_update(float fixed_delta_time) { RAIN__SCRIPT_CALL_(fixed_update, fixed_delta_time,); }
+void rain_script_late_update(float delta_time) { RAIN__SCRIPT_CALL_(late_update, delta_time,); }
+void rain_script_render(float alpha) { RAIN__SCRIPT_CALL_(render, alpha,); }
+void rain_script_resize(int width, int height) { RAIN__SCRIPT_CALL_(resize, width, height,); }
+void rain_script_destroy() { RAIN__SCRIPT_CALL_(destroy); }
@@ -0,0 +1,24 @@
+#ifndef RAIN__SCRIPT_H_
+#define RAIN__SCRIPT_H_
+
+#include <stdbool.h>
+#include <mono/metadata/assembly.h>
+
+/** resolve the managed `RainEngine.Main` entry points in `image` once.
+    missing ones are skipped when dispatched. */
+void rain_script_bind(MonoImage *image);
+
+/** true once a managed callback has thrown. the main loop should stop. */
+bool rain_script_failed();
+
+void rain_script_entry();
+void rain_script_update(float delta_time);
+void rain_script_fixed_update(float fixed_delta_time);
+void rain_script_late_update(float delta_time);
+/** `alpha` is how far into the next fixed step the frame is, [0, 1). */
+void rain_script_render(float alpha);
+/** framebuffer size changed. */
+void rain_script_resize(int width, int height);
+void rain_script_destroy();
+
+#endif // RAIN__SCRIPT_H_
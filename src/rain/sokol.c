@@ -1,5 +1,14 @@
 
 #include <GL/gl3w.h>
-#define SOKOL_IMPL
+// renderer.c counts what every module does with sokol through these.
+#define SOKOL_TRACE_HOOKS
 #define SOKOL_GLCORE33
+// declares sokol before the implementation, which has no include guard.
+#include "render_thread.h"
+#define SOKOL_IMPL
 #include <sokol_gfx.h>
+
+uint32_t rain_render_thread_gl_texture(sg_image image) {
+	const _sg_image_t *img = _sg_lookup_image(&_sg.pools, image.id);
+	return img ? img->gl.tex[img->cmn.active_slot] : 0;
+}
@@ -1,55 +1,225 @@
+#include <stdio.h>
+#include <stdlib.h>
 #include <rain/texture.h>
+#include <rain/texture_streaming.h>
+#include <rain/qoi.h>
+#include <GL/gl3w.h>
+#include "render_thread.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define RAIN__TEXTURE_SSSE3_ 1
+#endif
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
+/** what each layout is uploaded as, RGB is padded to RGBA. */
+static const sg_pixel_format rain__texture_pixel_formats_[] = {
+	[RAIN_TEXTURE_FORMAT_GREY] = SG_PIXELFORMAT_R8,
+	[RAIN_TEXTURE_FORMAT_GREY_ALPHA] = SG_PIXELFORMAT_RG8,
+	[RAIN_TEXTURE_FORMAT_RGB] = SG_PIXELFORMAT_RGBA8,
+	[RAIN_TEXTURE_FORMAT_RGB_ALPHA] = SG_PIXELFORMAT_RGBA8,
+};
+
+/** how shaders see the channels of the compact formats, as if they were RGBA. */
+static const GLint rain__texture_swizzles_[][4] = {
+	[RAIN_TEXTURE_FORMAT_GREY] = { GL_RED, GL_RED, GL_RED, GL_ONE },
+	[RAIN_TEXTURE_FORMAT_GREY_ALPHA] = { GL_RED, GL_RED, GL_RED, GL_GREEN },
+};
+
+/** runs between frames, every frame applies its state from scratch. */
+static void rain__texture_swizzle_(sg_image image, const void *arg) {
+	const GLint *swizzle = arg;
+	uint32_t texture = rain_render_thread_gl_texture(image);
+	if (!texture) return;
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	// sokol's idea of what is bound is off now.
+	sg_reset_state_cache();
+}
+
+#ifdef RAIN__TEXTURE_SSSE3_
+/** four pixels per shuffle. reads 16 bytes for every 12 it uses, so
+    the last few pixels are left to the caller. */
+[[gnu::target("ssse3")]]
+static size_t rain__texture_rgb_to_rgba_ssse3_(uint8_t *restrict dst, const uint8_t *restrict src, size_t pixels) {
+	const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+	const __m128i alpha = _mm_set1_epi32((int)0xff000000);
+	size_t done = 0;
+	// the load of the last group must stay inside `src`.
+	for (; done + 6 <= pixels; done += 4) {
+		__m128i rgb = _mm_loadu_si128((const __m128i *)(src + done * 3));
+		__m128i rgba = _mm_or_si128(_mm_shuffle_epi8(rgb, shuffle), alpha);
+		_mm_storeu_si128((__m128i *)(dst + done * 4), rgba);
+	}
+	return done;
+}
+#endif
+
+void rain_texture_rgb_to_rgba(uint8_t *restrict dst, const uint8_t *restrict src, size_t pixels) {
+	size_t done = 0;
+#ifdef RAIN__TEXTURE_SSSE3_
+	if (__builtin_cpu_supports("ssse3")) done = rain__texture_rgb_to_rgba_ssse3_(dst, src, pixels);
+#endif
+	for (; done < pixels; ++done) {
+		dst[done * 4 + 0] = src[done * 3 + 0];
+		dst[done * 4 + 1] = src[done * 3 + 1];
+		dst[done * 4 + 2] = src[done * 3 + 2];
+		dst[done * 4 + 3] = 0xff;
+	}
+}
+
+static uint8_t *rain__texture_read_file_(const char *path, size_t *out_size) {
+	FILE *file = fopen(path, "rb");
+	if (!file) return nullptr;
+	uint8_t *data = nullptr;
+	long size;
+	if (fseek(file, 0, SEEK_END) == 0 && (size = ftell(file)) >= 0 && fseek(file, 0, SEEK_SET) == 0) {
+		data = malloc(size > 0 ? size : 1);
+		if (fread(data, 1, size, file) != (size_t)size) {
+			free(data);
+			data = nullptr;
+		}
+		*out_size = size;
+	}
+	fclose(file);
+	return data;
+}
+
+/** keep the red (and alpha) channel of RGBA pixels, in place. */
+static void rain__texture_rgba_to_grey_(uint8_t *pixels, size_t count, int channels) {
+	for (size_t i = 0; i < count; ++i) {
+		pixels[i * channels] = pixels[i * 4];
+		if (channels == 2) pixels[i * 2 + 1] = pixels[i * 4 + 3];
+	}
+}
+
+uint8_t *rain_texture_load_pixels(
+	const char *restrict path,
+	int *restrict out_width,
+	int *restrict out_height,
+	int *restrict out_file_channels,
+	int channels
+) {
+	size_t size;
+	uint8_t *file = rain__texture_read_file_(path, &size);
+	if (!file) {
+		fprintf(stderr, "texture/ERR failed to read '%s'.\n", path);
+		return nullptr;
+	}
+
+	uint8_t *pixels;
+	struct rain_qoi_desc qoi;
+	if (rain_qoi_read_header(file, size, &qoi)) {
+		bool grey = channels == RAIN_TEXTURE_FORMAT_GREY || channels == RAIN_TEXTURE_FORMAT_GREY_ALPHA;
+		pixels = rain_qoi_decode(file, size, grey ? 4 : channels, true, &qoi);
+		if (pixels && grey) rain__texture_rgba_to_grey_(pixels, (size_t)qoi.width * qoi.height, channels);
+		if (!pixels) fprintf(stderr, "texture/ERR '%s' is not a valid QOI file.\n", path);
+		*out_width = qoi.width;
+		*out_height = qoi.height;
+		*out_file_channels = qoi.channels;
+	} else {
+		// thread local, textures are decoded on workers too.
+		stbi_set_flip_vertically_on_load_thread(1);
+		pixels = stbi_load_from_memory(file, size, out_width, out_height, out_file_channels, channels);
+		if (!pixels) fprintf(stderr, "texture/ERR failed to load '%s': %s\n", path, stbi_failure_reason());
+	}
+	free(file);
+	return pixels;
+}
+
+bool rain_texture_file_info(
+	const char *restrict path,
+	int *restrict out_width,
+	int *restrict out_height,
+	int *restrict out_channels
+) {
+	FILE *file = fopen(path, "rb");
+	if (!file) return false;
+	uint8_t header[RAIN_QOI_HEADER_SIZE];
+	size_t size = fread(header, 1, sizeof(header), file);
+	struct rain_qoi_desc qoi;
+	bool ok;
+	if (rain_qoi_read_header(header, size, &qoi)) {
+		*out_width = qoi.width;
+		*out_height = qoi.height;
+		*out_channels = qoi.channels;
+		ok = true;
+	} else {
+		fseek(file, 0, SEEK_SET);
+		ok = stbi_info_from_file(file, out_width, out_height, out_channels);
+	}
+	fclose(file);
+	return ok;
+}
+
 void rain_texture_from_file(
 	struct rain_texture *restrict this,
 	const char *restrict path,
 	enum rain_texture_format format,
 	sg_usage usage
 ) {
-	[[maybe_unused]] int channels;
+	int width, height, channels;
+	uint8_t *data = rain_texture_load_pixels(path, &width, &height, &channels, format);
+	if (!data) return;
+	rain_texture_from_pixels(this, data, width, height,
+		// the file's channels, not the ones it was converted to.
+		format != RAIN_TEXTURE_FORMAT_UNKNOWN ? format : channels,
+		usage);
+	free(data);
+}
+
+void rain_texture_from_pixels(
+	struct rain_texture *restrict this,
+	const uint8_t *restrict pixels,
+	int width, int height,
+	enum rain_texture_format format,
+	sg_usage usage
+) {
+	size_t count = (size_t)width * height;
+	uint8_t *expanded = nullptr;
+	if (format == RAIN_TEXTURE_FORMAT_RGB) {
+		// there is no 24 bit format to upload to.
+		expanded = malloc(count * 4);
+		rain_texture_rgb_to_rgba(expanded, pixels, count);
+		pixels = expanded;
+	}
+
+	this->width = width;
+	this->height = height;
 	this->usage = usage;
-	stbi_set_flip_vertically_on_load(1);
-	stbi_uc *data = stbi_load(path, &this->width, &this->height, &channels, format);
-	if (!data) {
-		fprintf(stderr, "texture/ERR failed to load texture at '%s': %s\n",
-			path, stbi_failure_reason());
-	}
-	// fprintf(stderr, "texture/INFO %dx%d @ %p\n", this->width, this->height, data);
-
-	sg_pixel_format pixel_format_map[] = {
-		0,
-		SG_PIXELFORMAT_R32F,
-		SG_PIXELFORMAT_RG16F,
-		SG_PIXELFORMAT_RGBA8, // the values won't be packed, so the alpha will be 0?
-		SG_PIXELFORMAT_RGBA8,
-	};
-
-	// channels instead of format because it might be 0.
-	// (so stbi uses whatever is in the image)
-	this->format = pixel_format_map[channels];
-
-	this->image = sg_make_image(&(sg_image_desc){
+	this->channels = format;
+	this->format = rain__texture_pixel_formats_[format];
+	// sokol has no swizzle, it is set as the image is made.
+	bool grey = format == RAIN_TEXTURE_FORMAT_GREY || format == RAIN_TEXTURE_FORMAT_GREY_ALPHA;
+	this->image = rain_render_thread_make_image_with(&(sg_image_desc){
 		.data.subimage[0][0] = {
-			.ptr = data,
-			.size = this->width * this->height * channels
+			.ptr = pixels,
+			.size = count * (format == RAIN_TEXTURE_FORMAT_RGB ? 4 : format),
 		},
-		.width = this->width,
-		.height = this->height,
+		.width = width,
+		.height = height,
 		.type = SG_IMAGETYPE_2D,
 		.num_slices = 1,
 		.pixel_format = this->format,
 		.num_mipmaps = 1,
-		.usage = usage
-	});
+		// dynamic ones are updated by `rain_texture_update` behind sokol's
+		// back, one GL texture holds them instead of one per frame in flight.
+		.usage = SG_USAGE_IMMUTABLE
+	}, grey ? &rain__texture_swizzle_ : nullptr, grey ? rain__texture_swizzles_[format] : nullptr);
 
-	stbi_image_free(data);
+	free(expanded);
 	this->exists = true;
 }
 
 void rain_texture_destroy(struct rain_texture *this) {
-	sg_destroy_image(this->image);
+	if (this->stream) {
+		rain_texture_stream_release(this->stream);
+		this->stream = nullptr;
+	}
+	rain_render_thread_destroy_image(this->image);
 	this->exists = false;
 }
@@ -0,0 +1,423 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <rain/texture_streaming.h>
+#include "engine.h"
+#include "render_thread.h"
+
+static int rain__texture_stream_mip_size_(int size, int mip) {
+	size >>= mip;
+	return size > 0 ? size : 1;
+}
+
+static size_t rain__texture_stream_chain_bytes_(int width, int height, int first, int count) {
+	size_t bytes = 0;
+	for (int mip = first; mip < count; ++mip) {
+		bytes += (size_t)rain__texture_stream_mip_size_(width, mip)
+			* rain__texture_stream_mip_size_(height, mip) * 4;
+	}
+	return bytes;
+}
+
+/** box-filter RGBA8 `src` down to half its size, odd edges are repeated.
+    `dst` may be `src`, every pixel is written after the ones it reads. */
+static void rain__texture_stream_halve_(uint8_t *dst, const uint8_t *src, int width, int height) {
+	int dst_w = rain__texture_stream_mip_size_(width, 1);
+	int dst_h = rain__texture_stream_mip_size_(height, 1);
+	for (int y = 0; y < dst_h; ++y) {
+		const uint8_t *row0 = src + (size_t)(2 * y < height ? 2 * y : height - 1) * width * 4;
+		const uint8_t *row1 = src + (size_t)(2 * y + 1 < height ? 2 * y + 1 : height - 1) * width * 4;
+		for (int x = 0; x < dst_w; ++x) {
+			int x0 = (2 * x < width ? 2 * x : width - 1) * 4;
+			int x1 = (2 * x + 1 < width ? 2 * x + 1 : width - 1) * 4;
+			uint8_t out[4];
+			for (int c = 0; c < 4; ++c) {
+				out[c] = (row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) / 4;
+			}
+			memcpy(dst + ((size_t)y * dst_w + x) * 4, out, 4);
+		}
+	}
+}
+
+/** the mips [first, count) of `full`, packed. `full` is scratch afterwards. */
+static uint8_t *rain__texture_stream_build_(uint8_t *full, int width, int height, int first, int count) {
+	int w = width, h = height;
+	for (int mip = 0; mip < first; ++mip) {
+		rain__texture_stream_halve_(full, full, w, h);
+		w = rain__texture_stream_mip_size_(w, 1);
+		h = rain__texture_stream_mip_size_(h, 1);
+	}
+	uint8_t *chain = malloc(rain__texture_stream_chain_bytes_(width, height, first, count));
+	memcpy(chain, full, (size_t)w * h * 4);
+	uint8_t *level = chain;
+	for (int mip = first + 1; mip < count; ++mip) {
+		uint8_t *next = level + (size_t)w * h * 4;
+		rain__texture_stream_halve_(next, level, w, h);
+		w = rain__texture_stream_mip_size_(w, 1);
+		h = rain__texture_stream_mip_size_(h, 1);
+		level = next;
+	}
+	return chain;
+}
+
+static sg_image rain__texture_stream_make_image_(
+	const struct rain_texture_stream *stream,
+	int width, int height,
+	const uint8_t *chain,
+	int first
+) {
+	sg_image_desc desc = {
+		.type = SG_IMAGETYPE_2D,
+		.width = rain__texture_stream_mip_size_(width, first),
+		.height = rain__texture_stream_mip_size_(height, first),
+		.num_slices = 1,
+		.num_mipmaps = stream->mip_count - first,
+		.pixel_format = SG_PIXELFORMAT_RGBA8,
+		.usage = SG_USAGE_IMMUTABLE,
+	};
+	for (int mip = first; mip < stream->mip_count; ++mip) {
+		size_t size = (size_t)rain__texture_stream_mip_size_(width, mip)
+			* rain__texture_stream_mip_size_(height, mip) * 4;
+		desc.data.subimage[0][mip - first] = (sg_range){ .ptr = chain, .size = size };
+		chain += size;
+	}
+	return rain_render_thread_make_image(&desc);
+}
+
+static void rain__texture_streaming_push_(
+	struct rain__texture_stream_job_ **jobs,
+	size_t *count, size_t *capacity,
+	struct rain__texture_stream_job_ job
+) {
+	if (*count == *capacity) {
+		*capacity = *capacity ? *capacity * 2 : 64;
+		*jobs = realloc(*jobs, *capacity * sizeof(**jobs));
+	}
+	(*jobs)[(*count)++] = job;
+}
+
+static void rain__texture_streaming_schedule_(
+	struct rain_texture_streaming *this,
+	struct rain__texture_stream_job_ job
+) {
+	rain__texture_streaming_push_(&this->pending, &this->pending_count, &this->pending_capacity, job);
+	struct rain__texture_stream_job_ *heap = this->pending;
+	for (size_t at = this->pending_count - 1; at > 0;) {
+		size_t parent = (at - 1) / 2;
+		if (heap[parent].priority >= heap[at].priority) break;
+		struct rain__texture_stream_job_ swap = heap[parent];
+		heap[parent] = heap[at];
+		heap[at] = swap;
+		at = parent;
+	}
+	cnd_signal(&this->wake);
+}
+
+static struct rain__texture_stream_job_ rain__texture_streaming_pop_(struct rain_texture_streaming *this) {
+	struct rain__texture_stream_job_ *heap = this->pending;
+	struct rain__texture_stream_job_ top = heap[0];
+	heap[0] = heap[--this->pending_count];
+	for (size_t at = 0;;) {
+		size_t largest = at, left = 2 * at + 1, right = left + 1;
+		if (left < this->pending_count && heap[left].priority > heap[largest].priority) largest = left;
+		if (right < this->pending_count && heap[right].priority > heap[largest].priority) largest = right;
+		if (largest == at) break;
+		struct rain__texture_stream_job_ swap = heap[largest];
+		heap[largest] = heap[at];
+		heap[at] = swap;
+		at = largest;
+	}
+	return top;
+}
+
+static int rain__texture_streaming_worker_(void *arg) {
+	struct rain_texture_streaming *this = arg;
+	mtx_lock(&this->lock);
+	for (;;) {
+		while (this->pending_count == 0 && !this->quit) cnd_wait(&this->wake, &this->lock);
+		if (this->quit) break;
+		struct rain__texture_stream_job_ job = rain__texture_streaming_pop_(this);
+		// the stream itself stays alive until its job is done.
+		struct rain_texture *texture = job.stream->texture;
+		int expected_width = texture ? texture->width : 0;
+		int expected_height = texture ? texture->height : 0;
+		mtx_unlock(&this->lock);
+
+		if (texture) {
+			int width, height, channels;
+			uint8_t *data = rain_texture_load_pixels(job.stream->path, &width, &height, &channels, 4);
+			// a failed load has been reported already.
+			if (data && (width != expected_width || height != expected_height)) {
+				fprintf(stderr, "texture/ERR '%s' changed size while streaming.\n", job.stream->path);
+			} else if (data) {
+				job.pixels = rain__texture_stream_build_(data, width, height, job.mip, job.stream->mip_count);
+			}
+			free(data);
+		}
+
+		mtx_lock(&this->lock);
+		rain__texture_streaming_push_(&this->done, &this->done_count, &this->done_capacity, job);
+		// an idle editor has to come around to swap it in.
+		rain_window_wake(&rain__engine_.window);
+	}
+	mtx_unlock(&this->lock);
+	return 0;
+}
+
+void rain_texture_streaming_init(struct rain_texture_streaming *this) {
+	*this = (struct rain_texture_streaming){
+		.enabled = true,
+		.budget = RAIN_TEXTURE_STREAMING_BUDGET,
+	};
+	const char *mode = getenv("RAIN_TEXTURE_STREAMING");
+	if (mode != nullptr && strcmp(mode, "off") == 0) this->enabled = false;
+	const char *budget = getenv("RAIN_TEXTURE_BUDGET_MB");
+	if (budget != nullptr) this->budget = strtoull(budget, nullptr, 10) << 20;
+}
+
+// the worker is only started once a texture is streamed.
+static void rain__texture_streaming_start_(struct rain_texture_streaming *this) {
+	mtx_init(&this->lock, mtx_plain);
+	cnd_init(&this->wake);
+	thrd_create(&this->worker, &rain__texture_streaming_worker_, this);
+	this->started = true;
+}
+
+void rain_texture_streaming_deinit(struct rain_texture_streaming *this) {
+	if (this->started) {
+		mtx_lock(&this->lock);
+		this->quit = true;
+		cnd_signal(&this->wake);
+		mtx_unlock(&this->lock);
+		thrd_join(this->worker, nullptr);
+
+		for (size_t i = 0; i < this->done_count; ++i) free(this->done[i].pixels);
+		free(this->pending);
+		free(this->done);
+		cnd_destroy(&this->wake);
+		mtx_destroy(&this->lock);
+	}
+	for (size_t i = 0; i < this->stream_count; ++i) {
+		struct rain_texture_stream *stream = this->streams[i];
+		// the texture keeps its image, it just isn't streamed anymore.
+		if (stream->texture) stream->texture->stream = nullptr;
+		free(stream->lower);
+		free(stream->path);
+		free(stream);
+	}
+	free(this->streams);
+	*this = (struct rain_texture_streaming){};
+}
+
+void rain_texture_streaming_load(
+	struct rain_texture_streaming *restrict this,
+	struct rain_texture *restrict texture,
+	const char *restrict path,
+	enum rain_texture_format format
+) {
+	int width, height, channels = format;
+	if (format == RAIN_TEXTURE_FORMAT_UNKNOWN && !rain_texture_file_info(path, &width, &height, &channels)) {
+		channels = 0;
+	}
+	// compact formats are a quarter of RGBA8 already.
+	if (!this->enabled || channels < RAIN_TEXTURE_FORMAT_RGB) {
+		rain_texture_from_file(texture, path, format, SG_USAGE_IMMUTABLE);
+		return;
+	}
+
+	uint8_t *data = rain_texture_load_pixels(path, &width, &height, &(int){0}, 4);
+	if (!data) return;
+
+	int longest = width > height ? width : height;
+	int mip_count = 1;
+	while ((longest >> mip_count) > 0 && mip_count < RAIN_TEXTURE_STREAMING_MAX_MIPS) ++mip_count;
+	int base_mip = 0;
+	while ((longest >> base_mip) > RAIN_TEXTURE_STREAMING_MIN_SIZE && base_mip < mip_count - 1) ++base_mip;
+
+	struct rain_texture_stream *stream = malloc(sizeof(*stream));
+	*stream = (struct rain_texture_stream){
+		.streaming = this,
+		.texture = texture,
+		.path = strdup(path),
+		.width = width,
+		.height = height,
+		.mip_count = mip_count,
+		.base_mip = base_mip,
+		.resident_mip = base_mip,
+		.wanted_mip = mip_count,
+		.loading_mip = -1,
+		.resident_bytes = rain__texture_stream_chain_bytes_(width, height, base_mip, mip_count),
+	};
+	// nothing is dropped before it had a chance to be drawn.
+	for (int mip = 0; mip < mip_count; ++mip) stream->last_wanted[mip] = this->frame;
+
+	uint8_t *chain = rain__texture_stream_build_(data, width, height, base_mip, mip_count);
+	free(data);
+	*texture = (struct rain_texture){
+		.exists = true,
+		.image = rain__texture_stream_make_image_(stream, width, height, chain, base_mip),
+		.width = width,
+		.height = height,
+		.format = SG_PIXELFORMAT_RGBA8,
+		.channels = channels,
+		.usage = SG_USAGE_IMMUTABLE,
+		.stream = stream,
+	};
+	free(chain);
+
+	if (!this->started) rain__texture_streaming_start_(this);
+	this->resident_bytes += stream->resident_bytes;
+	if (this->stream_count == this->stream_capacity) {
+		this->stream_capacity = this->stream_capacity ? this->stream_capacity * 2 : 64;
+		this->streams = realloc(this->streams, this->stream_capacity * sizeof(*this->streams));
+	}
+	this->streams[this->stream_count++] = stream;
+}
+
+void rain_texture_stream_release(struct rain_texture_stream *this) {
+	// any thread, textures are freed by the GC. the stream itself is
+	// freed by the next update that finds it without a job.
+	mtx_lock(&this->streaming->lock);
+	this->texture = nullptr;
+	mtx_unlock(&this->streaming->lock);
+}
+
+/** make an image of the chain from `mip` on and swap it in, false if the
+    texture was destroyed meanwhile. */
+static bool rain__texture_streaming_swap_(
+	struct rain_texture_streaming *this,
+	struct rain_texture_stream *stream,
+	int mip,
+	const uint8_t *pixels
+) {
+	mtx_lock(&this->lock);
+	bool alive = stream->texture != nullptr;
+	mtx_unlock(&this->lock);
+	if (!alive) return false;
+
+	sg_image image = rain__texture_stream_make_image_(
+		stream, stream->width, stream->height, pixels, mip);
+	sg_image old = { SG_INVALID_ID };
+
+	mtx_lock(&this->lock);
+	bool swapped = stream->texture && image.id != SG_INVALID_ID;
+	if (swapped) {
+		old = stream->texture->image;
+		stream->texture->image = image;
+	}
+	mtx_unlock(&this->lock);
+
+	if (swapped) {
+		size_t bytes = rain__texture_stream_chain_bytes_(
+			stream->width, stream->height, mip, stream->mip_count);
+		this->resident_bytes += bytes - stream->resident_bytes;
+		stream->resident_bytes = bytes;
+		stream->resident_mip = mip;
+		// frames already recorded still draw with the old one.
+		rain_render_thread_destroy_image(old);
+	} else if (image.id != SG_INVALID_ID) {
+		rain_render_thread_destroy_image(image);
+	}
+	return swapped;
+}
+
+static void rain__texture_streaming_apply_(
+	struct rain_texture_streaming *this,
+	struct rain__texture_stream_job_ *job
+) {
+	struct rain_texture_stream *stream = job->stream;
+	mtx_lock(&this->lock);
+	stream->loading_mip = -1;
+	mtx_unlock(&this->lock);
+	if (!job->pixels || !rain__texture_streaming_swap_(this, stream, job->mip, job->pixels)) return;
+
+	// keep what comes after the loaded mip, dropping it again only needs those.
+	int width = stream->width, height = stream->height;
+	size_t level = rain__texture_stream_chain_bytes_(width, height, job->mip, job->mip + 1);
+	size_t rest = rain__texture_stream_chain_bytes_(width, height, job->mip + 1, stream->mip_count);
+	free(stream->lower);
+	memmove(job->pixels, job->pixels + level, rest);
+	stream->lower = realloc(job->pixels, rest);
+	stream->lower_mip = job->mip + 1;
+	job->pixels = nullptr;
+}
+
+/** swap in the chain from one mip coarser, out of `lower`. */
+static void rain__texture_streaming_drop_(
+	struct rain_texture_streaming *this,
+	struct rain_texture_stream *stream
+) {
+	int mip = stream->resident_mip + 1;
+	size_t offset = rain__texture_stream_chain_bytes_(
+		stream->width, stream->height, stream->lower_mip, mip);
+	if (!rain__texture_streaming_swap_(this, stream, mip, stream->lower + offset)) return;
+	if (mip == stream->base_mip) {
+		free(stream->lower);
+		stream->lower = nullptr;
+	}
+}
+
+void rain_texture_streaming_update(struct rain_texture_streaming *this) {
+	if (!this->started) return;
+	this->frame += 1;
+
+	mtx_lock(&this->lock);
+	struct rain__texture_stream_job_ *done = this->done;
+	size_t done_count = this->done_count;
+	if (done_count > 0) {
+		this->done = nullptr;
+		this->done_count = this->done_capacity = 0;
+	}
+	mtx_unlock(&this->lock);
+	if (done_count > 0) {
+		for (size_t i = 0; i < done_count; ++i) {
+			rain__texture_streaming_apply_(this, &done[i]);
+			free(done[i].pixels);
+		}
+		free(done);
+	}
+
+	mtx_lock(&this->lock);
+	struct rain_texture_stream *drop = nullptr;
+	for (size_t i = 0; i < this->stream_count;) {
+		struct rain_texture_stream *stream = this->streams[i];
+		if (!stream->texture) {
+			if (stream->loading_mip < 0) {
+				this->resident_bytes -= stream->resident_bytes;
+				free(stream->lower);
+				free(stream->path);
+				free(stream);
+				this->streams[i] = this->streams[--this->stream_count];
+			} else {
+				++i;
+			}
+			continue;
+		}
+
+		for (int mip = stream->wanted_mip; mip < stream->mip_count; ++mip) {
+			stream->last_wanted[mip] = this->frame;
+		}
+		if (stream->wanted_mip < stream->resident_mip && stream->loading_mip < 0) {
+			stream->loading_mip = stream->wanted_mip;
+			// the blurriest first.
+			rain__texture_streaming_schedule_(this, (struct rain__texture_stream_job_){
+				.stream = stream,
+				.mip = stream->wanted_mip,
+				.priority = 1 + stream->resident_mip - stream->wanted_mip,
+			});
+		}
+		stream->wanted_mip = stream->mip_count;
+
+		// the finest mip that went unused the longest.
+		uint64_t last = stream->last_wanted[stream->resident_mip];
+		if (stream->resident_mip < stream->base_mip && stream->loading_mip < 0
+			&& this->frame - last > RAIN_TEXTURE_STREAMING_IDLE_FRAMES
+			&& (!drop || last < drop->last_wanted[drop->resident_mip])) {
+			drop = stream;
+		}
+		++i;
+	}
+	mtx_unlock(&this->lock);
+	// one mip at a time, the coarser ones are still in memory.
+	if (drop && this->resident_bytes > this->budget) rain__texture_streaming_drop_(this, drop);
+}
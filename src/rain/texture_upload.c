@@ -0,0 +1,151 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdalign.h>
+#include <rain/texture_upload.h>
+#include <rain/renderer.h>
+#include <GL/gl3w.h>
+#include "render_thread.h"
+#include "upload_ring.h"
+
+void rain_texture_uploads_init(
+	struct rain_texture_uploads *restrict this,
+	struct rain_renderer *restrict renderer
+) {
+	*this = (struct rain_texture_uploads){
+		.renderer = renderer,
+		.budget = RAIN_TEXTURE_UPLOAD_BUDGET,
+	};
+	const char *budget = getenv("RAIN_TEXTURE_UPLOAD_BUDGET_KB");
+	if (budget != nullptr) this->budget = strtoull(budget, nullptr, 10) << 10;
+}
+
+void rain_texture_uploads_deinit(struct rain_texture_uploads *this) {
+	free(this->queued);
+	free(this->bytes);
+	*this = (struct rain_texture_uploads){};
+}
+
+static GLenum rain__texture_upload_gl_format_(sg_pixel_format format) {
+	switch (format) {
+	case SG_PIXELFORMAT_R8: return GL_RED;
+	case SG_PIXELFORMAT_RG8: return GL_RG;
+	default: return GL_RGBA;
+	}
+}
+
+bool rain_texture_update(
+	struct rain_texture_uploads *restrict this,
+	const struct rain_texture *restrict texture,
+	int x, int y, int width, int height,
+	const uint8_t *restrict pixels,
+	size_t size
+) {
+	if (!texture->exists || texture->usage != SG_USAGE_DYNAMIC) {
+		fprintf(stderr, "upload/ERR only textures created with SG_USAGE_DYNAMIC can be updated.\n");
+		return false;
+	}
+	if (x < 0 || y < 0 || width <= 0 || height <= 0
+			|| width > texture->width - x || height > texture->height - y) {
+		fprintf(stderr, "upload/ERR rect %d,%d %dx%d is outside of the %dx%d texture.\n",
+			x, y, width, height, texture->width, texture->height);
+		return false;
+	}
+	size_t count = (size_t)width * height;
+	if (size != count * texture->channels) {
+		fprintf(stderr, "upload/ERR %zu bytes given for %zu texels of %d channels.\n",
+			size, count, (int)texture->channels);
+		return false;
+	}
+
+	// RGB is padded here already, the render thread only copies.
+	size_t bytes = texture->channels == RAIN_TEXTURE_FORMAT_RGB ? count * 4 : size;
+	if (this->bytes_size + bytes > this->bytes_capacity) {
+		size_t capacity = this->bytes_capacity ? this->bytes_capacity : 64 * 1024;
+		while (capacity < this->bytes_size + bytes) capacity *= 2;
+		this->bytes = realloc(this->bytes, capacity);
+		this->bytes_capacity = capacity;
+	}
+	uint8_t *dst = this->bytes + this->bytes_size;
+	if (texture->channels == RAIN_TEXTURE_FORMAT_RGB) rain_texture_rgb_to_rgba(dst, pixels, count);
+	else memcpy(dst, pixels, size);
+
+	if (this->queued_count == this->queued_capacity) {
+		this->queued_capacity = this->queued_capacity ? this->queued_capacity * 2 : 16;
+		this->queued = realloc(this->queued, this->queued_capacity * sizeof(*this->queued));
+	}
+	this->queued[this->queued_count++] = (struct rain__texture_update_){
+		.image = texture->image,
+		.format = texture->format,
+		.x = x, .y = y, .width = width, .height = height,
+		.offset = this->bytes_size,
+		.size = bytes,
+	};
+	this->bytes_size += bytes;
+	this->queued_serial += 1;
+	return true;
+}
+
+struct rain__texture_upload_cmd_ {
+	struct rain_texture_uploads *uploads;
+	uint32_t count, deferred;
+	/** followed by `count` updates and then their pixels. */
+	size_t size;
+	alignas(16) struct rain__texture_update_ updates[];
+};
+
+static void rain__texture_upload_execute_(void *payload) {
+	struct rain__texture_upload_cmd_ *cmd = payload;
+	struct rain_renderer_stats *stats = &cmd->uploads->renderer->current_.stats;
+	struct rain_upload upload = rain_upload_ring_push(cmd->updates + cmd->count, cmd->size);
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, upload.gl_buffer);
+	glActiveTexture(GL_TEXTURE0);
+	for (uint32_t i = 0; i < cmd->count; ++i) {
+		const struct rain__texture_update_ *update = &cmd->updates[i];
+		// destroyed since it was queued.
+		uint32_t texture = rain_render_thread_gl_texture(update->image);
+		if (!texture) continue;
+		glBindTexture(GL_TEXTURE_2D, texture);
+		glTexSubImage2D(GL_TEXTURE_2D, 0,
+			update->x, update->y, update->width, update->height,
+			rain__texture_upload_gl_format_(update->format), GL_UNSIGNED_BYTE,
+			(const void *)(uintptr_t)(upload.offset + update->offset));
+		stats->texture_updates += 1;
+		stats->texture_update_bytes += update->size;
+	}
+	stats->texture_updates_deferred = cmd->deferred;
+
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	// sokol's idea of what is bound is off now.
+	sg_reset_state_cache();
+}
+
+void rain_texture_uploads_flush(struct rain_texture_uploads *this) {
+	if (this->queued_count == 0) return;
+
+	size_t count = 0, size = 0;
+	while (count < this->queued_count
+			&& (count == 0 || size + this->queued[count].size <= this->budget)) {
+		size += this->queued[count++].size;
+	}
+
+	size_t updates_size = count * sizeof(struct rain__texture_update_);
+	struct rain__texture_upload_cmd_ *cmd = rain_render_thread_push(
+		&rain__texture_upload_execute_, sizeof(*cmd) + updates_size + size);
+	cmd->uploads = this;
+	cmd->count = count;
+	cmd->deferred = this->queued_count - count;
+	cmd->size = size;
+	// the queued bytes start at the first update's, so the offsets hold.
+	memcpy(cmd->updates, this->queued, updates_size);
+	memcpy((uint8_t *)(cmd->updates + count), this->bytes, size);
+
+	this->recorded_serial += count;
+	this->queued_count -= count;
+	memmove(this->queued, this->queued + count, this->queued_count * sizeof(*this->queued));
+	for (size_t i = 0; i < this->queued_count; ++i) this->queued[i].offset -= size;
+	this->bytes_size -= size;
+	memmove(this->bytes, this->bytes + size, this->bytes_size);
+}
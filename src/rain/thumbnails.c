@@ -0,0 +1,175 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <rain/thumbnails.h>
+#include "engine.h"
+
+#define RAIN__THUMBNAIL_BYTES_ (RAIN_THUMBNAIL_SIZE * RAIN_THUMBNAIL_SIZE * 4)
+
+static void rain__thumbnails_push_(
+	struct rain__thumbnail_job_ **jobs,
+	size_t *count, size_t *capacity,
+	struct rain__thumbnail_job_ job
+) {
+	if (*count == *capacity) {
+		*capacity = *capacity ? *capacity * 2 : 64;
+		*jobs = realloc(*jobs, *capacity * sizeof(**jobs));
+	}
+	(*jobs)[(*count)++] = job;
+}
+
+/** box-filter `src` down into a RAIN_THUMBNAIL_SIZE square, keeping the aspect ratio. */
+static void rain__thumbnails_downscale_(
+	uint8_t *restrict dst,
+	const uint8_t *restrict src,
+	int width, int height
+) {
+	memset(dst, 0, RAIN__THUMBNAIL_BYTES_);
+	int longest = width > height ? width : height;
+	int dst_w = width * RAIN_THUMBNAIL_SIZE / longest;
+	int dst_h = height * RAIN_THUMBNAIL_SIZE / longest;
+	if (dst_w < 1) dst_w = 1;
+	if (dst_h < 1) dst_h = 1;
+	int off_x = (RAIN_THUMBNAIL_SIZE - dst_w) / 2;
+	int off_y = (RAIN_THUMBNAIL_SIZE - dst_h) / 2;
+
+	for (int y = 0; y < dst_h; ++y) {
+		int y0 = y * height / dst_h, y1 = (y + 1) * height / dst_h;
+		if (y1 <= y0) y1 = y0 + 1;
+		for (int x = 0; x < dst_w; ++x) {
+			int x0 = x * width / dst_w, x1 = (x + 1) * width / dst_w;
+			if (x1 <= x0) x1 = x0 + 1;
+			uint32_t sum[4] = {};
+			for (int sy = y0; sy < y1; ++sy) {
+				const uint8_t *row = src + ((size_t)sy * width + x0) * 4;
+				for (int sx = x0; sx < x1; ++sx, row += 4) {
+					sum[0] += row[0]; sum[1] += row[1]; sum[2] += row[2]; sum[3] += row[3];
+				}
+			}
+			uint32_t n = (uint32_t)(x1 - x0) * (uint32_t)(y1 - y0);
+			uint8_t *out = dst + ((size_t)(y + off_y) * RAIN_THUMBNAIL_SIZE + x + off_x) * 4;
+			for (int c = 0; c < 4; ++c) out[c] = sum[c] / n;
+		}
+	}
+}
+
+static int rain__thumbnails_worker_(void *arg) {
+	struct rain_thumbnails *this = arg;
+	mtx_lock(&this->lock);
+	for (;;) {
+		while (this->pending_count == 0 && !this->quit) cnd_wait(&this->wake, &this->lock);
+		if (this->quit) break;
+		// newest first, those are the ones on screen.
+		struct rain__thumbnail_job_ job = this->pending[--this->pending_count];
+		mtx_unlock(&this->lock);
+
+		int width, height, channels;
+		uint8_t *data = rain_texture_load_pixels(job.path, &width, &height, &channels, 4);
+		if (data) {
+			job.pixels = malloc(RAIN__THUMBNAIL_BYTES_);
+			rain__thumbnails_downscale_(job.pixels, data, width, height);
+			free(data);
+		}
+		free(job.path);
+		job.path = nullptr;
+
+		mtx_lock(&this->lock);
+		rain__thumbnails_push_(&this->done, &this->done_count, &this->done_capacity, job);
+		// an idle editor has to come around to upload it.
+		rain_window_wake(&rain__engine_.window);
+	}
+	mtx_unlock(&this->lock);
+	return 0;
+}
+
+void rain_thumbnails_init(struct rain_thumbnails *this) {
+	*this = (struct rain_thumbnails){};
+}
+
+// the atlas and the worker are only created once something asks for a thumbnail.
+static void rain__thumbnails_start_(struct rain_thumbnails *this) {
+	uint8_t *pixels = calloc(1, RAIN_THUMBNAIL_ATLAS_SIZE * RAIN_THUMBNAIL_ATLAS_SIZE * 4);
+	rain_texture_from_pixels(&this->atlas, pixels,
+		RAIN_THUMBNAIL_ATLAS_SIZE, RAIN_THUMBNAIL_ATLAS_SIZE,
+		RAIN_TEXTURE_FORMAT_RGB_ALPHA, SG_USAGE_DYNAMIC);
+	free(pixels);
+
+	mtx_init(&this->lock, mtx_plain);
+	cnd_init(&this->wake);
+	thrd_create(&this->worker, &rain__thumbnails_worker_, this);
+	this->started = true;
+}
+
+void rain_thumbnails_deinit(struct rain_thumbnails *this) {
+	if (!this->started) return;
+
+	mtx_lock(&this->lock);
+	this->quit = true;
+	cnd_signal(&this->wake);
+	mtx_unlock(&this->lock);
+	thrd_join(this->worker, nullptr);
+
+	for (size_t i = 0; i < this->pending_count; ++i) free(this->pending[i].path);
+	for (size_t i = 0; i < this->done_count; ++i) free(this->done[i].pixels);
+	free(this->pending);
+	free(this->done);
+	cnd_destroy(&this->wake);
+	mtx_destroy(&this->lock);
+
+	rain_texture_destroy(&this->atlas);
+	*this = (struct rain_thumbnails){};
+}
+
+void rain_thumbnails_request(
+	struct rain_thumbnails *restrict this,
+	int slot,
+	uint32_t ticket,
+	const char *restrict path
+) {
+	if (slot < 0 || slot >= RAIN_THUMBNAIL_SLOTS) return;
+	if (!this->started) rain__thumbnails_start_(this);
+
+	mtx_lock(&this->lock);
+	this->requested_tickets[slot] = ticket;
+	rain__thumbnails_push_(&this->pending, &this->pending_count, &this->pending_capacity,
+		(struct rain__thumbnail_job_){ .slot = slot, .ticket = ticket, .path = strdup(path) });
+	cnd_signal(&this->wake);
+	mtx_unlock(&this->lock);
+}
+
+void rain_thumbnails_update(struct rain_thumbnails *this) {
+	if (!this->started) return;
+	struct rain_texture_uploads *uploads = &rain__engine_.texture_uploads;
+
+	// the C# side reads `ready_tickets` on this thread, between frames.
+	bool uploading = false;
+	for (int slot = 0; slot < RAIN_THUMBNAIL_SLOTS; ++slot) {
+		if (this->uploading_tickets[slot]
+				&& this->uploading_serials[slot] <= uploads->recorded_serial) {
+			this->ready_tickets[slot] = this->uploading_tickets[slot];
+			this->uploading_tickets[slot] = 0;
+		}
+		uploading |= this->uploading_tickets[slot] != 0;
+	}
+
+	mtx_lock(&this->lock);
+	for (size_t i = 0; i < this->done_count; ++i) {
+		struct rain__thumbnail_job_ *job = &this->done[i];
+		// the slot might have been given to another asset in the meantime.
+		if (job->pixels && job->ticket == this->requested_tickets[job->slot]
+				&& rain_texture_update(uploads, &this->atlas,
+					job->slot % RAIN_THUMBNAIL_ATLAS_COLUMNS * RAIN_THUMBNAIL_SIZE,
+					job->slot / RAIN_THUMBNAIL_ATLAS_COLUMNS * RAIN_THUMBNAIL_SIZE,
+					RAIN_THUMBNAIL_SIZE, RAIN_THUMBNAIL_SIZE,
+					job->pixels, RAIN__THUMBNAIL_BYTES_)) {
+			this->uploading_tickets[job->slot] = job->ticket;
+			this->uploading_serials[job->slot] = uploads->queued_serial;
+			uploading = true;
+		}
+		free(job->pixels);
+	}
+	this->done_count = 0;
+	mtx_unlock(&this->lock);
+	// an idle editor has to come around once more to show them.
+	if (uploading) rain_window_wake(&rain__engine_.window);
+}
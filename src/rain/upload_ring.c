@@ -0,0 +1,148 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <rain/renderer.h>
+#include <GL/gl3w.h>
+#include "upload_ring.h"
+
+#define RAIN__UPLOAD_RING_ALIGN_(SIZE) (((SIZE) + 15) & ~(size_t)15)
+
+struct rain__upload_ring_buffer_ {
+	GLuint gl_buffer;
+	/** sokol wants vertex and index buffers apart, both wrap `gl_buffer`. */
+	sg_buffer vertex_buffer, index_buffer;
+};
+
+static struct {
+	struct rain__upload_ring_buffer_ current;
+	size_t frame_size;
+	int frame;
+	/** into the frame's part. */
+	size_t offset;
+	GLsync fences[RAIN_UPLOAD_RING_FRAMES];
+	/** replaced by a larger one this frame, draws recorded before may still use them. */
+	struct rain__upload_ring_buffer_ *retired;
+	size_t retired_count, retired_capacity;
+	uint64_t frame_bytes;
+	uint32_t frame_waits;
+} ring_;
+
+static struct rain__upload_ring_buffer_ rain__upload_ring_make_(size_t size) {
+	struct rain__upload_ring_buffer_ buffer = {};
+	glGenBuffers(1, &buffer.gl_buffer);
+	// sokol caches what is bound to the vertex and index targets, not this one.
+	glBindBuffer(GL_COPY_WRITE_BUFFER, buffer.gl_buffer);
+	glBufferData(GL_COPY_WRITE_BUFFER, size, nullptr, GL_STREAM_DRAW);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	buffer.vertex_buffer = sg_make_buffer(&(sg_buffer_desc){
+		.label = "Upload Ring Vertices",
+		.size = size,
+		.type = SG_BUFFERTYPE_VERTEXBUFFER,
+		.gl_buffers[0] = buffer.gl_buffer,
+	});
+	buffer.index_buffer = sg_make_buffer(&(sg_buffer_desc){
+		.label = "Upload Ring Indices",
+		.size = size,
+		.type = SG_BUFFERTYPE_INDEXBUFFER,
+		.gl_buffers[0] = buffer.gl_buffer,
+	});
+	return buffer;
+}
+
+/** GL keeps the storage until the draws using it are done. */
+static void rain__upload_ring_destroy_(struct rain__upload_ring_buffer_ *buffer) {
+	// injected, so sokol leaves the GL buffer alone.
+	sg_destroy_buffer(buffer->vertex_buffer);
+	sg_destroy_buffer(buffer->index_buffer);
+	glDeleteBuffers(1, &buffer->gl_buffer);
+	*buffer = (struct rain__upload_ring_buffer_){};
+}
+
+void rain_upload_ring_init() {
+	ring_.frame_size = RAIN_UPLOAD_RING_FRAME_SIZE;
+	ring_.current = rain__upload_ring_make_(ring_.frame_size * RAIN_UPLOAD_RING_FRAMES);
+}
+
+void rain_upload_ring_deinit() {
+	for (int i = 0; i < RAIN_UPLOAD_RING_FRAMES; ++i) {
+		if (ring_.fences[i]) glDeleteSync(ring_.fences[i]);
+	}
+	for (size_t i = 0; i < ring_.retired_count; ++i) rain__upload_ring_destroy_(&ring_.retired[i]);
+	rain__upload_ring_destroy_(&ring_.current);
+	free(ring_.retired);
+	memset(&ring_, 0, sizeof(ring_));
+}
+
+void rain_upload_ring_begin_frame() {
+	ring_.frame = (ring_.frame + 1) % RAIN_UPLOAD_RING_FRAMES;
+	ring_.offset = 0;
+	ring_.frame_bytes = 0;
+	ring_.frame_waits = 0;
+
+	GLsync *fence = &ring_.fences[ring_.frame];
+	if (*fence == nullptr) return;
+	if (glClientWaitSync(*fence, 0, 0) == GL_TIMEOUT_EXPIRED) {
+		// the GPU is more than the frames in flight behind, nothing to do but wait.
+		ring_.frame_waits += 1;
+		glClientWaitSync(*fence, GL_SYNC_FLUSH_COMMANDS_BIT, UINT64_MAX);
+	}
+	glDeleteSync(*fence);
+	*fence = nullptr;
+}
+
+void rain_upload_ring_end_frame(struct rain_renderer_stats *stats) {
+	ring_.fences[ring_.frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	// every draw of the frame is issued by now.
+	for (size_t i = 0; i < ring_.retired_count; ++i) rain__upload_ring_destroy_(&ring_.retired[i]);
+	ring_.retired_count = 0;
+	stats->upload_ring_bytes += ring_.frame_bytes;
+	stats->upload_ring_waits += ring_.frame_waits;
+}
+
+/** a new buffer with room for `size` per frame. nothing in it is in use
+    yet, so the fences of the old one don't apply. */
+static void rain__upload_ring_grow_(size_t size) {
+	while (ring_.frame_size < size) ring_.frame_size *= 2;
+	fprintf(stderr, "upload/INFO growing the upload ring to %zu KiB per frame.\n",
+		ring_.frame_size >> 10);
+
+	if (ring_.retired_count == ring_.retired_capacity) {
+		ring_.retired_capacity = ring_.retired_capacity ? ring_.retired_capacity * 2 : 4;
+		ring_.retired = realloc(ring_.retired, ring_.retired_capacity * sizeof(*ring_.retired));
+	}
+	ring_.retired[ring_.retired_count++] = ring_.current;
+	ring_.current = rain__upload_ring_make_(ring_.frame_size * RAIN_UPLOAD_RING_FRAMES);
+	for (int i = 0; i < RAIN_UPLOAD_RING_FRAMES; ++i) {
+		if (ring_.fences[i]) glDeleteSync(ring_.fences[i]);
+		ring_.fences[i] = nullptr;
+	}
+	ring_.offset = 0;
+}
+
+struct rain_upload rain_upload_ring_push(const void *data, size_t size) {
+	if (ring_.offset + size > ring_.frame_size) rain__upload_ring_grow_(size);
+
+	size_t at = ring_.frame * ring_.frame_size + ring_.offset;
+	struct rain_upload upload = {
+		.vertex_buffer = ring_.current.vertex_buffer,
+		.index_buffer = ring_.current.index_buffer,
+		.gl_buffer = ring_.current.gl_buffer,
+		.offset = (int)at,
+	};
+	// GL refuses to map nothing.
+	if (size == 0) return upload;
+
+	glBindBuffer(GL_COPY_WRITE_BUFFER, ring_.current.gl_buffer);
+	// the fence said the GPU is done with this part, so no need for the driver to check.
+	void *dst = glMapBufferRange(GL_COPY_WRITE_BUFFER, at, size,
+		GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+	if (dst) memcpy(dst, data, size);
+	if (!dst || !glUnmapBuffer(GL_COPY_WRITE_BUFFER)) {
+		fprintf(stderr, "upload/ERR failed to write %zu bytes to the upload ring.\n", size);
+	}
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+	ring_.offset = RAIN__UPLOAD_RING_ALIGN_(ring_.offset + size);
+	ring_.frame_bytes += size;
+	return upload;
+}
@@ -0,0 +1,43 @@
+#ifndef RAIN__UPLOAD_RING_H_
+#define RAIN__UPLOAD_RING_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sokol_gfx.h>
+
+struct rain_renderer_stats;
+
+/** the ring is split into this many frames, each guarded by a fence.
+    one more than the frames in flight, so writing one never waits. */
+#define RAIN_UPLOAD_RING_FRAMES 3
+/** per frame to begin with, a frame of texture updates at the default
+    budget fits. grows when a frame needs more. */
+#define RAIN_UPLOAD_RING_FRAME_SIZE (4u << 20)
+
+/** where `rain_upload_ring_push` put the data. `vertex_buffer` and
+    `index_buffer` are the same GL buffer, bind either at `offset`. */
+struct rain_upload {
+	sg_buffer vertex_buffer, index_buffer;
+	uint32_t gl_buffer;
+	int offset;
+};
+
+/** a large GL buffer for whatever is uploaded fresh every frame (vertices,
+    indices, pixels), written without sync where the GPU is done reading.
+    render thread only, `rain_renderer_init`/`deinit` call these. */
+void rain_upload_ring_init();
+void rain_upload_ring_deinit();
+
+/** start writing the next frame's part, waits only if the GPU is further
+    behind than the frames in flight. */
+void rain_upload_ring_begin_frame();
+
+/** fence the frame's part and add what it did to `stats`. */
+void rain_upload_ring_end_frame(struct rain_renderer_stats *stats);
+
+/** copy `size` bytes into this frame's part, at a multiple of 16.
+    valid until the end of the frame. the buffers may change with every
+    push, bind the ones returned. */
+struct rain_upload rain_upload_ring_push(const void *data, size_t size);
+
+#endif // RAIN__UPLOAD_RING_H_
@@ -4,13 +4,52 @@
 #include <GL/gl3w.h>
 #include <sokol_gfx.h>
 #include <string.h>
+#include <stdatomic.h>
 #include "glfw.h"
 
 struct rain__window_handle_ {
 	GLFWwindow *w;
 	char *title;
+	/** set by the input callbacks and `rain_window_wake`. */
+	atomic_bool had_events;
+	/** raw timer value at creation, see `rain_window_get_time_ns`. */
+	uint64_t timer_start;
 };
 
+static void rain__window_mark_events_(GLFWwindow *w) {
+	struct rain__window_handle_ *handle = glfwGetWindowUserPointer(w);
+	atomic_store(&handle->had_events, true);
+}
+
+// imgui_impl_glfw chains to these, so they see all input.
+static void rain__window_on_key_(GLFWwindow *w, int key, int scancode, int action, int mods) {
+	rain__window_mark_events_(w);
+}
+static void rain__window_on_char_(GLFWwindow *w, unsigned int c) {
+	rain__window_mark_events_(w);
+}
+static void rain__window_on_mouse_button_(GLFWwindow *w, int button, int action, int mods) {
+	rain__window_mark_events_(w);
+}
+static void rain__window_on_cursor_pos_(GLFWwindow *w, double x, double y) {
+	rain__window_mark_events_(w);
+}
+static void rain__window_on_cursor_enter_(GLFWwindow *w, int entered) {
+	rain__window_mark_events_(w);
+}
+static void rain__window_on_scroll_(GLFWwindow *w, double x, double y) {
+	rain__window_mark_events_(w);
+}
+static void rain__window_on_focus_(GLFWwindow *w, int focused) {
+	rain__window_mark_events_(w);
+}
+static void rain__window_on_fb_size_(GLFWwindow *w, int width, int height) {
+	rain__window_mark_events_(w);
+}
+static void rain__window_on_refresh_(GLFWwindow *w) {
+	rain__window_mark_events_(w);
+}
+
 static void rain__glfw_error_(int error, const char *message) {
 	fprintf(stderr, "glfw/ERROR(%d) %s\n", error, message);
 }
@@ -32,18 +71,57 @@ void rain_window_init(
 	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 	this->handle->w = glfwCreateWindow(width, height, this->handle->title, nullptr, nullptr);
 	glfwMakeContextCurrent(this->handle->w);
+
+	GLFWwindow *w = this->handle->w;
+	glfwSetWindowUserPointer(w, this->handle);
+	glfwSetKeyCallback(w, &rain__window_on_key_);
+	glfwSetCharCallback(w, &rain__window_on_char_);
+	glfwSetMouseButtonCallback(w, &rain__window_on_mouse_button_);
+	glfwSetCursorPosCallback(w, &rain__window_on_cursor_pos_);
+	glfwSetCursorEnterCallback(w, &rain__window_on_cursor_enter_);
+	glfwSetScrollCallback(w, &rain__window_on_scroll_);
+	glfwSetWindowFocusCallback(w, &rain__window_on_focus_);
+	glfwSetFramebufferSizeCallback(w, &rain__window_on_fb_size_);
+	glfwSetWindowRefreshCallback(w, &rain__window_on_refresh_);
+
 	if (gl3wInit() < 0) {
 		fprintf(stderr, "gl3w/ERR failed to initialize :(\n");
 		exit(1);
 	}
 	glfwSwapInterval(1);
+	this->handle->timer_start = glfwGetTimerValue();
 }
 
 void rain_window_frame(struct rain_window *this) {
+	rain_window_swap(this);
+	rain_window_poll(this);
+}
+
+void rain_window_swap(struct rain_window *this) {
 	glfwSwapBuffers(this->handle->w);
+}
+
+void rain_window_poll(struct rain_window *this) {
 	glfwPollEvents();
 }
 
+void rain_window_make_current(struct rain_window *this, bool current) {
+	glfwMakeContextCurrent(current ? this->handle->w : nullptr);
+}
+
+void rain_window_wait(struct rain_window *this, double timeout) {
+	glfwWaitEventsTimeout(timeout);
+}
+
+void rain_window_wake(struct rain_window *this) {
+	atomic_store(&this->handle->had_events, true);
+	glfwPostEmptyEvent();
+}
+
+bool rain_window_take_events(struct rain_window *this) {
+	return atomic_exchange(&this->handle->had_events, false);
+}
+
 bool rain_window_should_close(struct rain_window *this) {
 	return glfwWindowShouldClose(this->handle->w);
 }
@@ -66,14 +144,30 @@ void rain_window_deinit(struct rain_window *this) {
 	free(this->handle);
 }
 
-float rain_window_get_time(struct rain_window *this) {
-	return glfwGetTime();
+uint64_t rain_window_get_time_ns(struct rain_window *this) {
+	uint64_t value = glfwGetTimerValue() - this->handle->timer_start;
+	uint64_t frequency = glfwGetTimerFrequency();
+	// split so `value * 1e9` can't overflow.
+	return value / frequency * 1000000000u
+		+ value % frequency * 1000000000u / frequency;
 }
 
 bool rain_window_is_key_down(struct rain_window *this, int keycode) {
 	return glfwGetKey(this->handle->w, keycode);
 }
 
+void rain_window_get_keys(
+	struct rain_window *restrict this,
+	bool *restrict out_down,
+	int count
+) {
+	// glfw reports an error for the codes below the first key.
+	for (int key = 0; key < count; ++key) {
+		out_down[key] = key >= GLFW_KEY_SPACE && key <= GLFW_KEY_LAST
+			&& glfwGetKey(this->handle->w, key) == GLFW_PRESS;
+	}
+}
+
 void rain_window_set_title(
 	struct rain_window *restrict this,
 	const char *restrict title
@@ -0,0 +1,147 @@
+// converts images to QOI and compares how fast both decode.
+//   qoitool convert <in.png> <out.qoi>
+//   qoitool bench <dir> [iterations]
+#define _XOPEN_SOURCE 700
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <ftw.h>
+#include <rain/qoi.h>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+static double qoitool_now_ms_() {
+	struct timespec ts;
+	timespec_get(&ts, TIME_UTC);
+	return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static uint8_t *qoitool_read_file_(const char *path, size_t *out_size) {
+	FILE *file = fopen(path, "rb");
+	if (!file) return nullptr;
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	uint8_t *data = malloc(size > 0 ? size : 1);
+	if (size < 0 || fread(data, 1, size, file) != (size_t)size) {
+		free(data);
+		data = nullptr;
+	}
+	fclose(file);
+	*out_size = size;
+	return data;
+}
+
+/** QOI only has RGB and RGBA, grey images become RGBA. */
+static uint8_t *qoitool_encode_(const uint8_t *file, size_t file_size, size_t *out_size) {
+	int width, height, channels;
+	if (!stbi_info_from_memory(file, file_size, &width, &height, &channels)) return nullptr;
+	if (channels < 3) channels = 4;
+	uint8_t *pixels = stbi_load_from_memory(file, file_size, &width, &height, &(int){0}, channels);
+	if (!pixels) return nullptr;
+	struct rain_qoi_desc desc = { width, height, channels, 0 };
+	uint8_t *qoi = rain_qoi_encode(pixels, &desc, out_size);
+	stbi_image_free(pixels);
+	return qoi;
+}
+
+static int qoitool_convert_(const char *in, const char *out) {
+	size_t file_size, qoi_size;
+	uint8_t *file = qoitool_read_file_(in, &file_size);
+	uint8_t *qoi = file ? qoitool_encode_(file, file_size, &qoi_size) : nullptr;
+	free(file);
+	if (!qoi) {
+		fprintf(stderr, "qoitool/ERR failed to load '%s': %s\n", in, stbi_failure_reason());
+		return 1;
+	}
+	FILE *dst = fopen(out, "wb");
+	bool ok = dst && fwrite(qoi, 1, qoi_size, dst) == qoi_size;
+	if (dst) ok = fclose(dst) == 0 && ok;
+	free(qoi);
+	if (!ok) {
+		fprintf(stderr, "qoitool/ERR failed to write '%s'.\n", out);
+		return 1;
+	}
+	return 0;
+}
+
+static struct {
+	int iterations;
+	/** decoded bytes and milliseconds over every file. */
+	double bytes, png_ms, qoi_ms;
+	size_t png_size, qoi_size;
+} bench_;
+
+static int qoitool_bench_file_(const char *path, const struct stat *st, int type, struct FTW *ftw) {
+	const char *ext = strrchr(path, '.');
+	if (type != FTW_F || !ext || (strcasecmp(ext, ".png") && strcasecmp(ext, ".jpg") && strcasecmp(ext, ".jpeg"))) {
+		return 0;
+	}
+
+	size_t file_size, qoi_size;
+	uint8_t *file = qoitool_read_file_(path, &file_size);
+	uint8_t *qoi = file ? qoitool_encode_(file, file_size, &qoi_size) : nullptr;
+	if (!qoi) {
+		fprintf(stderr, "qoitool/WARN skipping '%s'.\n", path);
+		free(file);
+		return 0;
+	}
+	struct rain_qoi_desc desc;
+	rain_qoi_read_header(qoi, qoi_size, &desc);
+	double bytes = (double)desc.width * desc.height * desc.channels * bench_.iterations;
+
+	// same work the engine does, flipped rows included.
+	stbi_set_flip_vertically_on_load(1);
+	double start = qoitool_now_ms_();
+	for (int i = 0; i < bench_.iterations; ++i) {
+		int w, h, c;
+		stbi_image_free(stbi_load_from_memory(file, file_size, &w, &h, &c, desc.channels));
+	}
+	double png_ms = qoitool_now_ms_() - start;
+
+	start = qoitool_now_ms_();
+	for (int i = 0; i < bench_.iterations; ++i) {
+		free(rain_qoi_decode(qoi, qoi_size, desc.channels, true, nullptr));
+	}
+	double qoi_ms = qoitool_now_ms_() - start;
+
+	printf("%-48s %5ux%-5u %8.1f MB/s %8.1f MB/s %7zu -> %7zu B\n", path, desc.width, desc.height,
+		bytes / 1e3 / png_ms, bytes / 1e3 / qoi_ms, file_size, qoi_size);
+	bench_.bytes += bytes;
+	bench_.png_ms += png_ms;
+	bench_.qoi_ms += qoi_ms;
+	bench_.png_size += file_size;
+	bench_.qoi_size += qoi_size;
+	free(qoi);
+	free(file);
+	return 0;
+}
+
+static int qoitool_bench_(const char *dir, int iterations) {
+	bench_.iterations = iterations > 0 ? iterations : 1;
+	printf("%-48s %11s %13s %13s %s\n", "file", "size", "stb_image", "qoi", "file size");
+	if (nftw(dir, &qoitool_bench_file_, 16, FTW_PHYS) != 0) {
+		fprintf(stderr, "qoitool/ERR failed to walk '%s'.\n", dir);
+		return 1;
+	}
+	if (bench_.bytes == 0) {
+		fprintf(stderr, "qoitool/ERR no images in '%s'.\n", dir);
+		return 1;
+	}
+	printf("bench/INFO stb_image=%.1fMB/s qoi=%.1fMB/s speedup=%.2fx png_bytes=%zu qoi_bytes=%zu\n",
+		bench_.bytes / 1e3 / bench_.png_ms, bench_.bytes / 1e3 / bench_.qoi_ms,
+		bench_.png_ms / bench_.qoi_ms, bench_.png_size, bench_.qoi_size);
+	return 0;
+}
+
+int main(int argc, char **argv) {
+	if (argc == 4 && strcmp(argv[1], "convert") == 0) return qoitool_convert_(argv[2], argv[3]);
+	if ((argc == 3 || argc == 4) && strcmp(argv[1], "bench") == 0) {
+		return qoitool_bench_(argv[2], argc == 4 ? atoi(argv[3]) : 50);
+	}
+	fprintf(stderr, "usage: %s convert <in> <out.qoi>\n       %s bench <dir> [iterations]\n", argv[0], argv[0]);
+	return 2;
+}